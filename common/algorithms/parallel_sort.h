@@ -254,7 +254,7 @@ namespace embree
     class ParallelRadixSort
   {
     static const size_t MAX_TASKS = 64;
-    static const size_t BITS = 8;
+    static const size_t BITS = 11; //!< 3 passes for 32 bit keys and 6 passes for 64 bit keys
     static const size_t BUCKETS = (1 << BITS);
     typedef unsigned int TyRadixCount[BUCKETS];
     
@@ -298,35 +298,52 @@ namespace embree
     }
     
   private:
+
+    __forceinline static size_t digit(const Ty& elt, const Key shift)
+    {
+      /* mask to extract some number of bits */
+      const Key mask = BUCKETS-1;
+#if defined(__64BIT__)
+      return ((size_t)(Key)elt >> (size_t)shift) & (size_t)mask;
+#else
+      return ((Key)elt >> shift) & mask;
+#endif
+    }
     
     void tbbRadixIteration0(const Key shift, 
                             const Ty* __restrict const src, 
-                            Ty* __restrict const dst, 
-                            const size_t threadIndex, const size_t threadCount)
+                            const size_t threadIndex, const size_t threadCount,
+                            const bool findDifferingBits)
     {
       const size_t startID = (threadIndex+0)*N/threadCount;
       const size_t endID   = (threadIndex+1)*N/threadCount;
       
-      /* mask to extract some number of bits */
-      const Key mask = BUCKETS-1;
-      
       /* count how many items go into the buckets */
-      for (size_t i=0; i<BUCKETS; i++)
-        radixCount[threadIndex][i] = 0;
+      unsigned int * __restrict const count = radixCount[threadIndex];
+      for (size_t i=0; i<BUCKETS; i+=VSIZEX)
+        vintx::store(&count[i], zero);
+
+      /* the first pass also determines which key bits differ, to skip passes over identical digits */
+      if (findDifferingBits)
+      {
+        Key keyOr = 0, keyAnd = Key(-1);
+        for (size_t i=startID; i<endID; i++) {
+          const Key key = (Key)src[i];
+          count[digit(src[i],shift)]++;
+          keyOr  |= key;
+          keyAnd &= key;
+        }
+        keyOrs[threadIndex] = keyOr;
+        keyAnds[threadIndex] = keyAnd;
+        return;
+      }
 
       /* iterate over src array and count buckets */
-      unsigned int * __restrict const count = radixCount[threadIndex];
 #if defined(__INTEL_COMPILER)
 #pragma nounroll      
 #endif
-      for (size_t i=startID; i<endID; i++) {
-#if defined(__64BIT__)
-        const size_t index = ((size_t)(Key)src[i] >> (size_t)shift) & (size_t)mask;
-#else
-        const Key index = ((Key)src[i] >> shift) & mask;
-#endif
-        count[index]++;
-      }
+      for (size_t i=startID; i<endID; i++)
+        count[digit(src[i],shift)]++;
     }
     
     void tbbRadixIteration1(const Key shift, 
@@ -337,9 +354,6 @@ namespace embree
       const size_t startID = (threadIndex+0)*N/threadCount;
       const size_t endID   = (threadIndex+1)*N/threadCount;
       
-      /* mask to extract some number of bits */
-      const Key mask = BUCKETS-1;
-      
       /* calculate total number of items for each bucket */
       __aligned(64) unsigned int total[BUCKETS];
       /*
@@ -375,56 +389,60 @@ namespace embree
         for (size_t j=0; j<BUCKETS; j+=VSIZEX)
           vintx::store(&offset[j], vintx::load(&offset[j]) + vintx::load(&radixCount[i][j]));
       }
-      
+
       /* copy items into their buckets */
 #if defined(__INTEL_COMPILER)
 #pragma nounroll
 #endif
       for (size_t i=startID; i<endID; i++) {
         const Ty elt = src[i];
-#if defined(__64BIT__)
-        const size_t index = ((size_t)(Key)src[i] >> (size_t)shift) & (size_t)mask;
-#else
-        const size_t index = ((Key)src[i] >> shift) & mask;
-#endif
-        dst[offset[index]++] = elt;
+        dst[offset[digit(elt,shift)]++] = elt;
       }
     }
     
-    void tbbRadixIteration(const Key shift, const bool last,
-                           const Ty* __restrict src, Ty* __restrict dst,
-                           const size_t numTasks)
-    {
-      affinity_partitioner ap;
-      parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration0(shift,src,dst,taskIndex,numTasks); },ap);
-      parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration1(shift,src,dst,taskIndex,numTasks); },ap);
-    }
-    
     void tbbRadixSort(const size_t numTasks)
     {
       radixCount = (TyRadixCount*) alignedMalloc(MAX_TASKS*sizeof(TyRadixCount),64);
-      
-      if (sizeof(Key) == sizeof(uint32_t)) {
-        tbbRadixIteration(0*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(1*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(2*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(3*BITS,1,tmp,src,numTasks);
+      affinity_partitioner ap;
+
+      /* count the lowest digit and find the key bits that differ between items */
+      parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration0(0,src,taskIndex,numTasks,true); },ap);
+      Key keyOr = 0, keyAnd = Key(-1);
+      for (size_t i=0; i<numTasks; i++) {
+        keyOr  |= keyOrs[i];
+        keyAnd &= keyAnds[i];
       }
-      else if (sizeof(Key) == sizeof(uint64_t))
+      const Key differingBits = keyOr ^ keyAnd;
+
+      /* sort by all digits that are not identical for all items */
+      Ty* in = src;
+      Ty* out = tmp;
+      bool counted = true;
+      for (size_t shift=0; shift<8*sizeof(Key); shift+=BITS)
       {
-        tbbRadixIteration(0*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(1*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(2*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(3*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(4*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(5*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(6*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(7*BITS,1,tmp,src,numTasks);
+        if ((((size_t)differingBits >> shift) & (BUCKETS-1)) == 0) {
+          counted = false;
+          continue;
+        }
+        if (!counted)
+          parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration0((Key)shift,in,taskIndex,numTasks,false); },ap);
+        parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration1((Key)shift,in,out,taskIndex,numTasks); },ap);
+        std::swap(in,out);
+        counted = false;
+      }
+
+      /* an odd number of passes leaves the sorted items in the temporary array */
+      if (in != src) {
+        parallel_for(size_t(0), N, size_t(8192), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) src[i] = tmp[i];
+          });
       }
     }
     
   private:
     TyRadixCount* radixCount;
+    Key keyOrs[MAX_TASKS];   //!< or over the keys of each task
+    Key keyAnds[MAX_TASKS];  //!< and over the keys of each task
     Ty* const src;
     Ty* const tmp;
     const size_t N;
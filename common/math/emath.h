@@ -51,6 +51,39 @@ namespace embree
   __forceinline int   asInt  (const float& a) { return *((int*)&a); }
   __forceinline float asFloat(const int&   a) { return *((float*)&a); }
 
+  /*! converts a half precision float given by its bits to single precision */
+  __forceinline float half_to_float(const unsigned short h)
+  {
+    const int sign = int(h & 0x8000) << 16;
+    const int exponent = (h >> 10) & 0x1f;
+    const int mantissa = h & 0x3ff;
+    if (exponent == 0x1f) return cast_i2f(sign | 0x7f800000 | (mantissa << 13)); // infinity and NaN
+    if (exponent == 0) { // zero and denormals
+      const float f = float(mantissa)*(1.0f/16777216.0f);
+      return sign ? -f : f;
+    }
+    return cast_i2f(sign | ((exponent+112) << 23) | (mantissa << 13));
+  }
+
+  /*! converts a single precision float to the bits of the nearest half precision float */
+  __forceinline unsigned short float_to_half(const float f)
+  {
+    const int i = cast_f2i(f);
+    const int sign = (i >> 16) & 0x8000;
+    const int exponent = ((i >> 23) & 0xff) - 112;
+    int mantissa = i & 0x7fffff;
+    if (exponent == 0xff-112) return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0)); // infinity and NaN
+    if (exponent <= 0) { // zero and denormals
+      if (exponent < -10) return (unsigned short)sign;
+      mantissa |= 0x800000;
+      const int shift = 14-exponent;
+      return (unsigned short)(sign | ((mantissa + (1 << (shift-1))) >> shift));
+    }
+    const int h = (exponent << 10) + ((mantissa + 0x1000) >> 13); // rounding may carry into the exponent
+    if (h >= 0x7c00) return (unsigned short)(sign | 0x7c00); // overflow to infinity
+    return (unsigned short)(sign | h);
+  }
+
 #if defined(__WIN32__)
   __forceinline bool finite ( const float x ) { return _finite(x) != 0; }
 #endif
@@ -463,6 +496,19 @@ __forceinline float nmsub ( const float a, const float b, const float c) { retur
 
     return x | (y << 1) | (z << 2);
   }
+
+#if defined(__AVX2__) && !defined(__aarch64__)
+
+  template<>
+    __forceinline uint64_t bitInterleave64(const uint64_t& xi, const uint64_t& yi, const uint64_t& zi)
+  {
+    const uint64_t xx = pdep(size_t(xi),size_t(0x1249249249249249) /* every third bit starting at bit 0 */);
+    const uint64_t yy = pdep(size_t(yi),size_t(0x2492492492492492) /* every third bit starting at bit 1 */);
+    const uint64_t zz = pdep(size_t(zi),size_t(0x4924924924924924) /* every third bit starting at bit 2 */);
+    return xx | yy | zz;
+  }
+
+#endif
 }
 
 #endif
@@ -30,7 +30,8 @@ namespace embree
         for (size_t j=0; j<1024; j+=threadCount)
         {
           if (!pred()) return;
-          if (thread.scheduler->steal_from_other_threads(thread)) {
+          if (threadPool->steal_from_higher_priority(thread,thread.scheduler->priority) ||
+              thread.scheduler->steal_from_other_threads(thread)) {
             i=j=0;
             body();
           }
@@ -77,20 +78,20 @@ namespace embree
   bool TaskScheduler::TaskQueue::execute_local_internal(Thread& thread, Task* parent)
   {
     /* stop if we run out of local tasks or reach the waiting task */
-    if (right == 0 || &tasks[right-1] == parent)
+    if (right == 0 || &task(right-1) == parent)
       return false;
 
     /* execute task */
     size_t oldRight = right;
-    tasks[right-1].run_internal(thread);
+    task(right-1).run_internal(thread);
     if (right != oldRight) {
       THROW_RUNTIME_ERROR("you have to wait for spawned subtasks");
     }
 
     /* pop task and closure from stack */
     right--;
-    if (tasks[right].stackPtr != size_t(-1))
-      stackPtr = tasks[right].stackPtr;
+    if (task(right).stackPtr != size_t(-1))
+      stackPtr = task(right).stackPtr;
 
     /* also move left pointer */
     if (left >= right) left.store(right.load());
@@ -104,6 +105,7 @@ namespace embree
 
   bool TaskScheduler::TaskQueue::steal(Thread& thread)
   {
+    Task& child = thread.tasks.top();
     size_t l = left;
     size_t r = right;
     if (l < r)
@@ -115,7 +117,7 @@ namespace embree
     else
       return false;
 
-    if (!tasks[l].try_steal(thread.tasks.tasks[thread.tasks.right]))
+    if (!task(l).try_steal(child))
       return false;
 
     thread.tasks.right++;
@@ -126,7 +128,53 @@ namespace embree
   size_t TaskScheduler::TaskQueue::getTaskSizeAtLeft()
   {
     if (left >= right) return 0;
-    return tasks[left].N;
+    return task(left).N;
+  }
+
+  dll_export TaskScheduler::TaskQueue::~TaskQueue()
+  {
+    for (size_t i=1; i<MAX_TASK_BLOCKS; i++) {
+      Task* block = taskBlocks[i].load();
+      if (block == nullptr) break;
+      for (size_t j=0; j<TASK_BLOCK_SIZE; j++) block[j].~Task();
+      alignedFree(block);
+    }
+    for (size_t i=1; i<MAX_CLOSURE_BLOCKS; i++) {
+      if (closureBlocks[i] == nullptr) break;
+      alignedFree(closureBlocks[i]);
+    }
+  }
+
+  dll_export TaskScheduler::Task* TaskScheduler::TaskQueue::growTasks(size_t block)
+  {
+    if (block >= MAX_TASK_BLOCKS)
+      throw std::runtime_error("task stack overflow");
+
+    /* tasks of the new block have to be in DONE state before other threads can see them */
+    Task* tasks = (Task*) alignedMalloc(TASK_BLOCK_SIZE*sizeof(Task),64);
+    for (size_t i=0; i<TASK_BLOCK_SIZE; i++) new (&tasks[i]) Task;
+    taskBlocks[block].store(tasks);
+    return tasks;
+  }
+
+  dll_export void* TaskScheduler::TaskQueue::allocSlow(size_t bytes, size_t align)
+  {
+    size_t begin = stackPtr + ((align - stackPtr) & (align-1));
+    size_t block = begin/CLOSURE_BLOCK_SIZE;
+
+    /* continue at the beginning of the next block if the closure does not fit into the current one */
+    if (begin+bytes > (block+1)*CLOSURE_BLOCK_SIZE) {
+      block++;
+      begin = block*CLOSURE_BLOCK_SIZE;
+    }
+    if (bytes > CLOSURE_BLOCK_SIZE || block >= MAX_CLOSURE_BLOCKS)
+      throw std::runtime_error("closure stack overflow");
+
+    if (closureBlocks[block] == nullptr)
+      closureBlocks[block] = (char*) alignedMalloc(CLOSURE_BLOCK_SIZE,64);
+
+    stackPtr = begin+bytes;
+    return &closureBlocks[block][begin-block*CLOSURE_BLOCK_SIZE];
   }
 
   void threadPoolFunction(std::pair<TaskScheduler::ThreadPool*,size_t>* pair)
@@ -138,7 +186,11 @@ namespace embree
   }
 
   TaskScheduler::ThreadPool::ThreadPool(bool set_affinity)
-    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), running(false) {}
+    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), running(false)
+  {
+    for (size_t i=0; i<NUM_PRIORITIES; i++)
+      numSchedulers[i] = 0;
+  }
 
   dll_export void TaskScheduler::ThreadPool::startThreads()
   {
@@ -195,7 +247,8 @@ namespace embree
   dll_export void TaskScheduler::ThreadPool::add(const Ref<TaskScheduler>& scheduler)
   {
     mutex.lock();
-    schedulers.push_back(scheduler);
+    schedulers[scheduler->priority].push_back(scheduler);
+    numSchedulers[scheduler->priority]++;
     mutex.unlock();
     condition.notify_all();
   }
@@ -203,14 +256,31 @@ namespace embree
   dll_export void TaskScheduler::ThreadPool::remove(const Ref<TaskScheduler>& scheduler)
   {
     Lock<MutexSys> lock(mutex);
-    for (std::list<Ref<TaskScheduler> >::iterator it = schedulers.begin(); it != schedulers.end(); it++) {
+    std::list<Ref<TaskScheduler> >& lane = schedulers[scheduler->priority];
+    for (std::list<Ref<TaskScheduler> >::iterator it = lane.begin(); it != lane.end(); it++) {
       if (scheduler == *it) {
-        schedulers.erase(it);
+        lane.erase(it);
+        numSchedulers[scheduler->priority]--;
         return;
       }
     }
   }
 
+  bool TaskScheduler::ThreadPool::steal_from_higher_priority(Thread& thread, Priority priority)
+  {
+    for (int p=NUM_PRIORITIES-1; p>int(priority); p--)
+    {
+      if (numSchedulers[p] == 0)
+        continue;
+
+      Lock<MutexSys> lock(mutex);
+      for (auto& scheduler : schedulers[p])
+        if (scheduler->steal_as_guest(thread))
+          return true;
+    }
+    return false;
+  }
+
   void TaskScheduler::ThreadPool::thread_loop(size_t globalThreadIndex)
   {
     while (globalThreadIndex < numThreadsRunning)
@@ -219,17 +289,28 @@ namespace embree
       ssize_t threadIndex = -1;
       {
         Lock<MutexSys> lock(mutex);
-        condition.wait(mutex, [&] () { return globalThreadIndex >= numThreadsRunning || !schedulers.empty(); });
+        auto anySchedulers = [&] () {
+          for (size_t p=0; p<NUM_PRIORITIES; p++)
+            if (!schedulers[p].empty()) return true;
+          return false;
+        };
+        condition.wait(mutex, [&] () { return globalThreadIndex >= numThreadsRunning || anySchedulers(); });
         if (globalThreadIndex >= numThreadsRunning) break;
-        scheduler = schedulers.front();
+
+        /* join a scheduler of highest priority */
+        for (int p=NUM_PRIORITIES-1; p>=0; p--) {
+          if (schedulers[p].empty()) continue;
+          scheduler = schedulers[p].front();
+          break;
+        }
         threadIndex = scheduler->allocThreadIndex();
       }
       scheduler->thread_loop(threadIndex);
     }
   }
 
-  TaskScheduler::TaskScheduler()
-    : threadCounter(0), anyTasksRunning(0), hasRootTask(false)
+  TaskScheduler::TaskScheduler(Priority priority)
+    : threadCounter(0), anyTasksRunning(0), hasRootTask(false), numGuests(0), priority(priority)
   {
     assert(threadPool);
     threadLocal.resize(2 * TaskScheduler::threadCount()); // FIXME: this has to be 2x as in the compatibility join mode with rtcCommitScene the worker threads also join. When disallowing rtcCommitScene to join a build we can remove the 2x.
@@ -347,13 +428,13 @@ namespace embree
     threadLocal[threadIndex].store(nullptr);
     swapThread(oldThread);
 
-    /* wait for all threads to terminate */
+    /* wait for all threads and guests to terminate */
     threadCounter--;
 #if defined(__WIN32__)
 	size_t loopIndex = 1;
 #endif
 #define LOOP_YIELD_THRESHOLD (4096)
-	while (threadCounter > 0) {
+	while (threadCounter > 0 || numGuests > 0) {
 #if defined(__WIN32__)
           if ((loopIndex % LOOP_YIELD_THRESHOLD) == 0)
             yield();
@@ -388,6 +469,22 @@ namespace embree
     return false;
   }
 
+  bool TaskScheduler::steal_as_guest(Thread& thread)
+  {
+    /* registering as guest keeps the thread structures of this scheduler alive */
+    numGuests++;
+    bool success = false;
+    const size_t threadCount = min(size_t(this->threadCounter),threadLocal.size());
+    for (size_t i=0; i<threadCount && !success; i++)
+    {
+      Thread* othread = threadLocal[i].load();
+      if (othread && othread != &thread)
+        success = othread->tasks.steal(thread);
+    }
+    numGuests--;
+    return success;
+  }
+
   dll_export void TaskScheduler::startThreads() {
     threadPool->startThreads();
   }
@@ -28,8 +28,20 @@ namespace embree
     ALIGNED_STRUCT_(64);
     friend class Device;
 
-    static const size_t TASK_STACK_SIZE = 4*1024;           //!< task structure stack
-    static const size_t CLOSURE_STACK_SIZE = 512*1024;    //!< stack for task closures
+    static const size_t TASK_BLOCK_SIZE = 4*1024;         //!< number of tasks per block of the task stack
+    static const size_t MAX_TASK_BLOCKS = 64;             //!< maximal number of blocks of the task stack
+    static const size_t CLOSURE_BLOCK_SIZE = 512*1024;    //!< bytes per block of the closure stack
+    static const size_t MAX_CLOSURE_BLOCKS = 64;          //!< maximal number of blocks of the closure stack
+
+    /*! priority lanes of the thread pool, idle threads join schedulers
+     *  of higher priority first and threads of lower priority
+     *  schedulers steal tasks of higher priority schedulers first */
+    enum Priority
+    {
+      PRIORITY_BACKGROUND = 0,
+      PRIORITY_INTERACTIVE = 1,
+      NUM_PRIORITIES = 2
+    };
 
     struct Thread;
 
@@ -122,30 +134,58 @@ namespace embree
       size_t N;                          //!< approximative size of task
     };
 
+    /*! Task stack and closure stack of a thread. Both stacks consist
+     *  of blocks, the first block is stored inline and further blocks
+     *  get allocated on demand when the stack grows. Blocks never move
+     *  and are only freed when the queue gets destroyed, thus other
+     *  threads can safely access tasks and closures while the stack
+     *  grows. */
     struct TaskQueue
     {
       TaskQueue ()
-      : left(0), right(0), stackPtr(0) {}
+      : left(0), right(0), stackPtr(0)
+      {
+        taskBlocks[0] = tasks;
+        for (size_t i=1; i<MAX_TASK_BLOCKS; i++) taskBlocks[i] = nullptr;
+        closureBlocks[0] = stack;
+        for (size_t i=1; i<MAX_CLOSURE_BLOCKS; i++) closureBlocks[i] = nullptr;
+      }
+
+      dll_export ~TaskQueue ();
+
+      /*! returns the i'th task of the task stack */
+      __forceinline Task& task(size_t i) {
+        return taskBlocks[i/TASK_BLOCK_SIZE].load()[i%TASK_BLOCK_SIZE];
+      }
+
+      /*! returns the task slot on top of the task stack, grows the stack if required */
+      __forceinline Task& top()
+      {
+        const size_t i = right;
+        const size_t b = i/TASK_BLOCK_SIZE;
+        Task* block = b < MAX_TASK_BLOCKS ? taskBlocks[b].load() : nullptr;
+        if (unlikely(block == nullptr)) block = growTasks(b);
+        return block[i%TASK_BLOCK_SIZE];
+      }
 
       __forceinline void* alloc(size_t bytes, size_t align = 64)
       {
-        size_t ofs = bytes + ((align - stackPtr) & (align-1));
-        if (stackPtr + ofs > CLOSURE_STACK_SIZE)
-          throw std::runtime_error("closure stack overflow");
-        stackPtr += ofs;
-        return &stack[stackPtr-bytes];
+        const size_t begin = stackPtr + ((align - stackPtr) & (align-1));
+        const size_t block = begin/CLOSURE_BLOCK_SIZE;
+        if (unlikely(block >= MAX_CLOSURE_BLOCKS || begin+bytes > (block+1)*CLOSURE_BLOCK_SIZE || closureBlocks[block] == nullptr))
+          return allocSlow(bytes,align);
+        stackPtr = begin+bytes;
+        return &closureBlocks[block][begin-block*CLOSURE_BLOCK_SIZE];
       }
 
       template<typename Closure>
       __forceinline void push_right(Thread& thread, const size_t size, const Closure& closure, TaskGroupContext* context)
       {
-        if (right >= TASK_STACK_SIZE)
-          throw std::runtime_error("task stack overflow");
-
 	/* allocate new task on right side of stack */
+        Task& task = top();
         size_t oldStackPtr = stackPtr;
         TaskFunction* func = new (alloc(sizeof(ClosureTaskFunction<Closure>))) ClosureTaskFunction<Closure>(closure);
-        new (&tasks[right.load()]) Task(func,thread.task,context,oldStackPtr,size);
+        new (&task) Task(func,thread.task,context,oldStackPtr,size);
         right++;
 
 	/* also move left pointer */
@@ -159,15 +199,25 @@ namespace embree
 
       bool empty() { return right == 0; }
 
+    private:
+
+      /*! allocates the next block of the task stack */
+      dll_export Task* growTasks(size_t block);
+
+      /*! allocates a closure in a new block of the closure stack */
+      dll_export void* allocSlow(size_t bytes, size_t align);
+
     public:
 
       /* task stack */
-      Task tasks[TASK_STACK_SIZE];
+      Task tasks[TASK_BLOCK_SIZE];                        //!< first block of the task stack
+      std::atomic<Task*> taskBlocks[MAX_TASK_BLOCKS];     //!< all blocks of the task stack
       __aligned(64) std::atomic<size_t> left;   //!< threads steal from left
       __aligned(64) std::atomic<size_t> right;  //!< new tasks are added to the right
 
       /* closure stack */
-      __aligned(64) char stack[CLOSURE_STACK_SIZE];
+      __aligned(64) char stack[CLOSURE_BLOCK_SIZE];       //!< first block of the closure stack
+      char* closureBlocks[MAX_CLOSURE_BLOCKS];            //!< all blocks of the closure stack
       size_t stackPtr;
     };
 
@@ -207,6 +257,9 @@ namespace embree
       /*! remove the task scheduler object again */
       dll_export void remove(const Ref<TaskScheduler>& scheduler);
 
+      /*! steals a task from a scheduler of higher priority than the specified one */
+      bool steal_from_higher_priority(Thread& thread, Priority priority);
+
       /*! returns number of threads of the thread pool */
       size_t size() const { return numThreads; }
 
@@ -223,10 +276,11 @@ namespace embree
     private:
       MutexSys mutex;
       ConditionSys condition;
-      std::list<Ref<TaskScheduler> > schedulers;
+      std::list<Ref<TaskScheduler> > schedulers[NUM_PRIORITIES];  //!< one scheduling lane per priority
+      std::atomic<size_t> numSchedulers[NUM_PRIORITIES];          //!< number of schedulers in each lane
     };
 
-    TaskScheduler ();
+    TaskScheduler (Priority priority = PRIORITY_INTERACTIVE);
     ~TaskScheduler ();
 
     /*! initializes the task scheduler */
@@ -251,6 +305,12 @@ namespace embree
     /*! steals a task from a different thread */
     bool steal_from_other_threads(Thread& thread);
 
+    /*! lets a thread of a different scheduler steal a task from some thread of this scheduler */
+    bool steal_as_guest(Thread& thread);
+
+    /*! returns the priority of this scheduler */
+    __forceinline Priority getPriority() const { return priority; }
+
     template<typename Predicate, typename Body>
       static void steal_loop(Thread& thread, const Predicate& pred, const Body& body);
 
@@ -287,9 +347,9 @@ namespace embree
       std::exception_ptr except = nullptr;
       if (context->cancellingException != nullptr) except = context->cancellingException;
 
-      /* wait for all threads to terminate */
+      /* wait for all threads and guests to terminate */
       threadCounter--;
-      while (threadCounter > 0) yield();
+      while (threadCounter > 0 || numGuests > 0) yield();
       context->cancellingException = nullptr;
 
       /* re-throw proper exception */
@@ -366,6 +426,8 @@ namespace embree
     std::atomic<size_t> threadCounter;
     std::atomic<size_t> anyTasksRunning;
     std::atomic<bool> hasRootTask;
+    std::atomic<size_t> numGuests;         //!< number of threads of other schedulers currently stealing from this scheduler
+    const Priority priority;               //!< priority lane of this scheduler
     MutexSys mutex;
     ConditionSys condition;
 
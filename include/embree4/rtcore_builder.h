@@ -37,11 +37,28 @@ typedef void* (*RTCCreateLeafFunction) (RTCThreadLocalAllocator allocator, const
 /* Callback to split a build primitive */
 typedef void (*RTCSplitPrimitiveFunction) (const struct RTCBuildPrimitive* primitive, unsigned int dimension, float position, struct RTCBounds* leftBounds, struct RTCBounds* rightBounds, void* userPtr);
 
+/* Time range of a motion blur BVH node */
+struct RTCTimeRange
+{
+  float lower;
+  float upper;
+};
+
+/* Callback to calculate the linear bounds of a build primitive over a time range */
+typedef void (*RTCPrimitiveLinearBoundsFunction) (const struct RTCBuildPrimitive* primitive, float time0, float time1, struct RTCLinearBounds* bounds, void* userPtr);
+
+/* Callback to set the linear bounds and time ranges of all children */
+typedef void (*RTCSetNodeLinearBoundsFunction) (void* nodePtr, const struct RTCLinearBounds** bounds, const struct RTCTimeRange* timeRanges, unsigned int childCount, void* userPtr);
+
 /* Build flags */
 enum RTCBuildFlags
 {
   RTC_BUILD_FLAG_NONE    = 0,
   RTC_BUILD_FLAG_DYNAMIC = (1 << 0),
+  RTC_BUILD_FLAG_MORTON_64 = (1 << 1),
+  RTC_BUILD_FLAG_FLAT_NODES = (1 << 2),
+  RTC_BUILD_FLAG_PRESPLITS = (1 << 3),
+  RTC_BUILD_FLAG_INCREMENTAL = (1 << 4),
 };
 
 enum RTCBuildConstants
@@ -49,6 +66,18 @@ enum RTCBuildConstants
   RTC_BUILD_MAX_PRIMITIVES_PER_LEAF = 32
 };
 
+/* Flag marking leaves in the count of a flat BVH node */
+#define RTC_FLAT_BVH_LEAF_FLAG 0x80000000u
+
+/* Node of a BVH built with RTC_BUILD_FLAG_FLAT_NODES */
+struct RTC_ALIGN(32) RTCFlatBVHNode
+{
+  float lower_x, lower_y, lower_z;
+  unsigned int offset;
+  float upper_x, upper_y, upper_z;
+  unsigned int count;
+};
+
 /* Input for builders */
 struct RTCBuildArguments
 {
@@ -76,6 +105,14 @@ struct RTCBuildArguments
   RTCSplitPrimitiveFunction splitPrimitive;
   RTCProgressMonitorFunction buildProgress;
   void* userPtr;
+
+  const float* vertices;
+  size_t vertexStride;
+  const unsigned int* indices;
+
+  unsigned int timeSegmentCount;
+  RTCPrimitiveLinearBoundsFunction primitiveLinearBounds;
+  RTCSetNodeLinearBoundsFunction setNodeLinearBounds;
 };
 
 /* Returns the default build settings.  */
@@ -103,6 +140,12 @@ RTC_FORCEINLINE struct RTCBuildArguments rtcDefaultBuildArguments()
   args.splitPrimitive = NULL;
   args.buildProgress = NULL;
   args.userPtr = NULL;
+  args.vertices = NULL;
+  args.vertexStride = 3*sizeof(float);
+  args.indices = NULL;
+  args.timeSegmentCount = 0;
+  args.primitiveLinearBounds = NULL;
+  args.setNodeLinearBounds = NULL;
   return args;
 }
 
@@ -112,6 +155,21 @@ RTC_API RTCBVH rtcNewBVH(RTCDevice device);
 /* Builds a BVH. */
 RTC_API void* rtcBuildBVH(const struct RTCBuildArguments* args);
 
+/* Returns the number of nodes of a BVH built with RTC_BUILD_FLAG_FLAT_NODES. */
+RTC_API size_t rtcGetBVHNodeCount(RTCBVH bvh);
+
+/* Returns the nodes of a BVH built with RTC_BUILD_FLAG_FLAT_NODES. */
+RTC_API const struct RTCFlatBVHNode* rtcGetBVHNodes(RTCBVH bvh);
+
+/* Returns the primitives referenced by the leaves of a BVH built with RTC_BUILD_FLAG_INCREMENTAL. */
+RTC_API const struct RTCBuildPrimitive* rtcGetBVHPrimitives(RTCBVH bvh);
+
+/* Inserts primitives into a BVH built with RTC_BUILD_FLAG_INCREMENTAL. */
+RTC_API void rtcInsertBVHPrimitives(RTCBVH bvh, const struct RTCBuildPrimitive* primitives, size_t primitiveCount);
+
+/* Removes primitives from a BVH built with RTC_BUILD_FLAG_INCREMENTAL. */
+RTC_API void rtcRemoveBVHPrimitives(RTCBVH bvh, const struct RTCBuildPrimitive* primitives, size_t primitiveCount);
+
 /* Allocates memory using the thread local allocator. */
 RTC_API void* rtcThreadLocalAlloc(RTCThreadLocalAllocator allocator, size_t bytes, size_t align);
 
@@ -150,6 +150,9 @@ enum RTCFormat
   RTC_FORMAT_GRID = 0xA001,
 
   RTC_FORMAT_QUATERNION_DECOMPOSITION = 0xB001,
+
+  /* special 16-byte format of 8 half floats for compact instance transformations */
+  RTC_FORMAT_QUATERNION_TRANSLATION_SCALE_HALF = 0xB002,
 };
 
 /* Build quality levels */
@@ -161,6 +161,9 @@ RTC_API void rtcSetGeometryMask(RTCGeometry geometry, unsigned int mask);
 /* Sets the build quality of the geometry. */
 RTC_API void rtcSetGeometryBuildQuality(RTCGeometry geometry, enum RTCBuildQuality quality);
 
+/* Sets the estimated cost to intersect a primitive of the geometry, in units of a triangle intersection. */
+RTC_API void rtcSetGeometryIntersectionCost(RTCGeometry geometry, float cost);
+
 /* Sets the maximal curve or point radius scale allowed by min-width feature. */
 RTC_API void rtcSetGeometryMaxRadiusScale(RTCGeometry geometry, float maxRadiusScale);
 
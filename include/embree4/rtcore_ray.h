@@ -51,6 +51,13 @@ struct RTCRayHit
   struct RTCHit hit;
 };
 
+/* Hit structure of a multi-hit query */
+struct RTC_ALIGN(16) RTCMultiHit
+{
+  struct RTCHit hit; // hit data
+  float t;           // hit distance
+};
+
 /* Ray structure for a packet of 4 rays */
 struct RTC_ALIGN(16) RTCRay4
 {
@@ -22,6 +22,16 @@ enum RTCSceneFlags
   RTC_SCENE_FLAG_ROBUST                       = (1 << 2),
   RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS = (1 << 3),
   RTC_SCENE_FLAG_PREFETCH_USM_SHARED_ON_GPU   = (1 << 4),
+  RTC_SCENE_FLAG_BACKGROUND_BUILD             = (1 << 5),
+  RTC_SCENE_FLAG_WATERTIGHT                   = (1 << 6),
+};
+
+/* Traversal cost of a single ray */
+struct RTCRayCost
+{
+  unsigned int nodes;      // visited inner nodes
+  unsigned int leaves;     // tested leaves
+  unsigned int primitives; // intersected primitives
 };
 
 /* Additional arguments for rtcIntersect1/4/8/16 calls */
@@ -35,6 +45,10 @@ struct RTCIntersectArguments
 #if RTC_MIN_WIDTH
   float minWidthDistanceFactor;            // curve radius is set to this factor times distance to ray origin
 #endif
+  float curveLODDistanceFactor;            // round curves thinner than this factor times distance to ray origin are intersected as flat curves
+  float rayConeWidth;                      // width of the ray footprint at the ray origin
+  float rayConeSpread;                     // increase of the ray footprint width per unit of ray distance
+  struct RTCRayCost* cost;                 // optional pointer that receives the traversal cost of single rays
 };
 
 /* Initializes intersection arguments. */
@@ -49,6 +63,10 @@ RTC_FORCEINLINE void rtcInitIntersectArguments(struct RTCIntersectArguments* arg
 #if RTC_MIN_WIDTH
   args->minWidthDistanceFactor = 0.0f;
 #endif
+  args->curveLODDistanceFactor = 0.0f;
+  args->rayConeWidth = 0.0f;
+  args->rayConeSpread = 0.0f;
+  args->cost = NULL;
 }
 
 /* Additional arguments for rtcOccluded1/4/8/16 calls */
@@ -63,6 +81,10 @@ struct RTCOccludedArguments
 #if RTC_MIN_WIDTH
   float minWidthDistanceFactor;            // curve radius is set to this factor times distance to ray origin
 #endif
+  float curveLODDistanceFactor;            // round curves thinner than this factor times distance to ray origin are intersected as flat curves
+  float rayConeWidth;                      // width of the ray footprint at the ray origin
+  float rayConeSpread;                     // increase of the ray footprint width per unit of ray distance
+  struct RTCRayCost* cost;                 // optional pointer that receives the traversal cost of single rays
 };
 
 /* Initializes an intersection arguments. */
@@ -77,6 +99,10 @@ RTC_FORCEINLINE void rtcInitOccludedArguments(struct RTCOccludedArguments* args)
 #if RTC_MIN_WIDTH
   args->minWidthDistanceFactor = 0.0f;
 #endif
+  args->curveLODDistanceFactor = 0.0f;
+  args->rayConeWidth = 0.0f;
+  args->rayConeSpread = 0.0f;
+  args->cost = NULL;
 }
 
 /* Creates a new scene. */
@@ -128,9 +154,70 @@ typedef bool (*RTCProgressMonitorFunction)(void* ptr, double n);
 /* Sets the progress monitor callback function of the scene. */
 RTC_API void rtcSetSceneProgressMonitorFunction(RTCScene scene, RTCProgressMonitorFunction progress, void* ptr);
 
+/* Build phases of a scene commit */
+enum RTCBuildPhase
+{
+  RTC_BUILD_PHASE_COMMIT             = 0, // entire commit of the scene
+  RTC_BUILD_PHASE_PRIMREF_GENERATION = 1, // creation of the primitive references
+  RTC_BUILD_PHASE_PRESPLIT           = 2, // pre-splitting of large primitives
+  RTC_BUILD_PHASE_BINNING            = 3, // construction of the hierarchy
+  RTC_BUILD_PHASE_LEAF_CREATION      = 4, // creation of the leaves, nested in binning
+  RTC_BUILD_PHASE_ALLOCATOR_WAIT     = 5, // block allocation of the node allocator, nested in binning
+  RTC_BUILD_PHASE_REFIT              = 6, // refitting of per-geometry BVHs
+  RTC_BUILD_PHASE_TOP_LEVEL_BUILD    = 7, // build over the per-geometry BVHs of a two-level build
+  RTC_BUILD_PHASE_COUNT              = 8
+};
+
+/* Timings and counters of a build phase */
+struct RTCBuildPhaseStatistics
+{
+  enum RTCBuildPhase parent; // phase this phase is nested in
+  size_t count;              // number of times the phase got executed
+  size_t numPrimitives;      // number of primitives processed by the phase
+  double time;               // accumulated time of all executions in seconds
+};
+
+/* Statistics of the last commit of a scene */
+struct RTCSceneCommitStatistics
+{
+  struct RTCBuildPhaseStatistics phases[RTC_BUILD_PHASE_COUNT];
+};
+
+/* Returns the statistics of the last commit of the scene. */
+RTC_API void rtcGetSceneCommitStatistics(RTCScene scene, struct RTCSceneCommitStatistics* stats);
+
+/* Number of power of two bins of the traversal statistics histograms */
+#define RTC_TRAVERSAL_HISTOGRAM_BINS 16
+
+/* Distribution of a per ray traversal count */
+struct RTCTraversalCounter
+{
+  size_t total;                                   // sum over all sampled rays
+  size_t max;                                     // maximum of a single sampled ray
+  size_t histogram[RTC_TRAVERSAL_HISTOGRAM_BINS]; // number of sampled rays per power of two bin of the count
+};
+
+/* Traversal statistics of the sampled rays */
+struct RTCTraversalStatistics
+{
+  size_t numRays;                        // number of sampled rays
+  struct RTCTraversalCounter nodes;      // visited inner nodes
+  struct RTCTraversalCounter leaves;     // tested leaves
+  struct RTCTraversalCounter primitives; // intersected primitives
+};
+
+/* Returns the traversal statistics of the scene or of one of its geometries. */
+RTC_API void rtcGetSceneTraversalStatistics(RTCScene scene, unsigned int geomID, struct RTCTraversalStatistics* stats);
+
+/* Resets the traversal statistics of the scene. */
+RTC_API void rtcResetSceneTraversalStatistics(RTCScene scene);
+
 /* Sets the build quality of the scene. */
 RTC_API void rtcSetSceneBuildQuality(RTCScene scene, enum RTCBuildQuality quality);
 
+/* Sets a sample of the expected ray distribution to guide the BVH build of the scene. */
+RTC_API void rtcSetSceneRayDistributionHint(RTCScene scene, const struct RTCRay* rays, size_t numRays, float weight);
+
 /* Sets the scene flags. */
 RTC_API void rtcSetSceneFlags(RTCScene scene, enum RTCSceneFlags flags);
 
@@ -160,6 +247,12 @@ RTC_API bool rtcPointQuery16(const int* valid, RTCScene scene, struct RTCPointQu
 /* Intersects a single ray with the scene. */
 RTC_SYCL_API void rtcIntersect1(RTCScene scene, struct RTCRayHit* rayhit, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
 
+/* Finds any hit of a single ray with the scene, terminating the traversal at the first hit found. */
+RTC_API void rtcIntersectAny(RTCScene scene, struct RTCRayHit* rayhit, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Finds the closest hits of a single ray with the scene, sorted by distance. */
+RTC_API unsigned int rtcIntersectMulti(RTCScene scene, struct RTCRay* ray, struct RTCMultiHit* hits, unsigned int maxHits, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
 /* Intersects a packet of 4 rays with the scene. */
 RTC_API void rtcIntersect4(const int* valid, RTCScene scene, struct RTCRayHit4* rayhit, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
 
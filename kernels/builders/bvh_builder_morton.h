@@ -49,9 +49,18 @@ namespace embree
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
       };
 
+      struct MortonCodeMapping;
+      struct MortonCodeMapping64;
+      struct MortonCodeGenerator;
+      struct MortonCodeGenerator64;
+
       /*! Build primitive consisting of morton code and primitive ID. */
       struct __aligned(8) BuildPrim
       {
+        typedef unsigned int Code;                  //!< type of the morton code
+        typedef MortonCodeMapping Mapping;          //!< maps bounds to morton codes
+        typedef MortonCodeGenerator Generator;      //!< fills arrays of build primitives
+
         union {
           struct {
             unsigned int code;     //!< morton code
@@ -67,6 +76,24 @@ namespace embree
         __forceinline bool operator<(const BuildPrim &m) const { return code < m.code; }
       };
 
+      /*! Build primitive consisting of 63 bit morton code and primitive ID, used for
+       *  scenes whose extent is too large for 10 bits of precision per axis. */
+      struct __aligned(8) BuildPrim64
+      {
+        typedef uint64_t Code;                      //!< type of the morton code
+        typedef MortonCodeMapping64 Mapping;        //!< maps bounds to morton codes
+        typedef MortonCodeGenerator64 Generator;    //!< fills arrays of build primitives
+
+        uint64_t code;         //!< morton code
+        unsigned int index;    //!< i'th primitive
+
+        /*! interface for radix sort */
+        __forceinline operator uint64_t() const { return code; }
+
+        /*! interface for standard sort */
+        __forceinline bool operator<(const BuildPrim64 &m) const { return code < m.code; }
+      };
+
       /*! maps bounding box to morton code */
       struct MortonCodeMapping
       {
@@ -102,6 +129,58 @@ namespace embree
         }
       };
 
+      /*! maps bounding box to 63 bit morton code */
+      struct MortonCodeMapping64
+      {
+        static const size_t LATTICE_BITS_PER_DIM = 21;
+        static const size_t LATTICE_SIZE_PER_DIM = size_t(1) << LATTICE_BITS_PER_DIM;
+
+        vfloat4 base;
+        vfloat4 scale;
+
+        __forceinline MortonCodeMapping64(const BBox3fa& bounds)
+        {
+          base  = (vfloat4)bounds.lower;
+          const vfloat4 diag  = (vfloat4)bounds.upper - (vfloat4)bounds.lower;
+          scale = select(diag > vfloat4(1E-19f), rcp(diag) * vfloat4(LATTICE_SIZE_PER_DIM * 0.99f),vfloat4(0.0f));
+        }
+
+        __forceinline const vint4 bin (const BBox3fa& box) const
+        {
+          const vfloat4 lower = (vfloat4)box.lower;
+          const vfloat4 upper = (vfloat4)box.upper;
+          const vfloat4 centroid = lower+upper;
+          return vint4((centroid-base)*scale);
+        }
+
+        __forceinline uint64_t code (const BBox3fa& box) const
+        {
+          const vint4 binID = bin(box);
+          const uint64_t x = (unsigned int) extract<0>(binID);
+          const uint64_t y = (unsigned int) extract<1>(binID);
+          const uint64_t z = (unsigned int) extract<2>(binID);
+          return bitInterleave64(x,y,z);
+        }
+      };
+
+      /*! 64 bit codes are always interleaved with scalar code, which uses pdep for AVX2 */
+      struct MortonCodeGenerator64
+      {
+        __forceinline MortonCodeGenerator64(const MortonCodeMapping64& mapping, BuildPrim64* dest)
+          : mapping(mapping), dest(dest) {}
+
+        __forceinline void operator() (const BBox3fa& b, const unsigned index)
+        {
+          dest->index = index;
+          dest->code = mapping.code(b);
+          dest++;
+        }
+
+      public:
+        const MortonCodeMapping64 mapping;
+        BuildPrim64* dest;
+      };
+
 #if defined (__AVX2__) || defined(__SYCL_DEVICE_ONLY__)
 
       /*! for AVX2 there is a fast scalar bitInterleave */
@@ -172,6 +251,43 @@ namespace embree
 
 #endif
 
+      /*! sorts build primitives by morton code using the parallel radix sort */
+      static __forceinline void sortMortonCodes(BuildPrim* src, BuildPrim* tmp, size_t numPrimitives, size_t blockSize) {
+        radix_sort_u32(src,tmp,numPrimitives,blockSize);
+      }
+
+      static __forceinline void sortMortonCodes(BuildPrim64* src, BuildPrim64* tmp, size_t numPrimitives, size_t blockSize) {
+        radix_sort_u64(src,tmp,numPrimitives,blockSize);
+      }
+
+      /*! sorts build primitives by morton code in place */
+      static __forceinline void sortMortonCodesInPlace(BuildPrim* morton, size_t numPrimitives)
+      {
+#if defined(TASKING_TBB)
+        tbb::parallel_sort(morton,morton+numPrimitives);
+#else
+        radixsort32(morton,numPrimitives);
+#endif
+      }
+
+      static __forceinline void sortMortonCodesInPlace(BuildPrim64* morton, size_t numPrimitives)
+      {
+#if defined(TASKING_TBB)
+        tbb::parallel_sort(morton,morton+numPrimitives);
+#else
+        std::sort(morton,morton+numPrimitives);
+#endif
+      }
+
+      /*! number of leading zero bits of a morton code */
+      static __forceinline unsigned int leadingZeros(unsigned int code) {
+        return lzcnt(code);
+      }
+
+      static __forceinline unsigned int leadingZeros(uint64_t code) {
+        return code ? unsigned(63-bsr(size_t(code))) : 64;
+      }
+
       template<
         typename ReductionTy,
         typename Allocator,
@@ -180,12 +296,17 @@ namespace embree
         typename SetNodeBoundsFunc,
         typename CreateLeafFunc,
         typename CalculateBounds,
-        typename ProgressMonitor>
+        typename ProgressMonitor,
+        typename BuildPrimTy = BuildPrim>
 
         class BuilderT : private Settings
       {
         ALIGNED_CLASS_(16);
 
+        typedef typename BuildPrimTy::Code Code;
+        typedef typename BuildPrimTy::Mapping Mapping;
+        static const unsigned int CODE_BITS = 8*sizeof(Code);
+
       public:
 
         BuilderT (CreateAllocator& createAllocator,
@@ -273,7 +394,7 @@ namespace embree
               centBounds.extend(center2(calculateBounds(morton[i])));
 
             /* recalculate morton codes */
-            MortonCodeMapping mapping(centBounds);
+            Mapping mapping(centBounds);
             for (size_t i=current.begin(); i<current.end(); i++)
               morton[i].code = mapping.code(calculateBounds(morton[i]));
 
@@ -293,7 +414,7 @@ namespace embree
                                                        BBox3fa(empty), calculateCentBounds, BBox3fa::merge);
 
             /* recalculate morton codes */
-            MortonCodeMapping mapping(centBounds);
+            Mapping mapping(centBounds);
             parallel_for(current.begin(), current.end(), unsigned(1024), [&] ( const range<unsigned>& r ) {
                 for (size_t i=r.begin(); i<r.end(); i++) {
                   morton[i].code = mapping.code(calculateBounds(morton[i]));
@@ -301,45 +422,41 @@ namespace embree
               });
 
             /*! sort morton codes */
-#if defined(TASKING_TBB)
-            tbb::parallel_sort(morton+current.begin(),morton+current.end());
-#else
-            radixsort32(morton+current.begin(),current.size());
-#endif
+            sortMortonCodesInPlace(morton+current.begin(),current.size());
           }
         }
 
         __forceinline void split(const range<unsigned>& current, range<unsigned>& left, range<unsigned>& right) const
         {
-          const unsigned int code_start = morton[current.begin()].code;
-          const unsigned int code_end   = morton[current.end()-1].code;
-          unsigned int bitpos = lzcnt(code_start^code_end);
+          const Code code_start = morton[current.begin()].code;
+          const Code code_end   = morton[current.end()-1].code;
+          unsigned int bitpos = leadingZeros(code_start^code_end);
 
           /* if all items mapped to same morton code, then re-create new morton codes for the items */
-          if (unlikely(bitpos == 32))
+          if (unlikely(bitpos == CODE_BITS))
           {
             recreateMortonCodes(current);
-            const unsigned int code_start = morton[current.begin()].code;
-            const unsigned int code_end   = morton[current.end()-1].code;
-            bitpos = lzcnt(code_start^code_end);
+            const Code code_start = morton[current.begin()].code;
+            const Code code_end   = morton[current.end()-1].code;
+            bitpos = leadingZeros(code_start^code_end);
 
             /* if the morton code is still the same, goto fall back split */
-            if (unlikely(bitpos == 32)) {
+            if (unlikely(bitpos == CODE_BITS)) {
               current.split(left,right);
               return;
             }
           }
 
           /* split the items at the topmost different morton code bit */
-          const unsigned int bitpos_diff = 31-bitpos;
-          const unsigned int bitmask = 1 << bitpos_diff;
+          const unsigned int bitpos_diff = CODE_BITS-1-bitpos;
+          const Code bitmask = Code(1) << bitpos_diff;
 
           /* find location where bit differs using binary search */
           unsigned begin = current.begin();
           unsigned end   = current.end();
           while (begin + 1 != end) {
             const unsigned mid = (begin+end)/2;
-            const unsigned bit = morton[mid].code & bitmask;
+            const Code bit = morton[mid].code & bitmask;
             if (bit == 0) begin = mid; else end = mid;
           }
           unsigned center = end;
@@ -432,11 +549,11 @@ namespace embree
         }
 
         /* build function */
-        ReductionTy build(BuildPrim* src, BuildPrim* tmp, size_t numPrimitives)
+        ReductionTy build(BuildPrimTy* src, BuildPrimTy* tmp, size_t numPrimitives)
         {
           /* sort morton codes */
           morton = src;
-          radix_sort_u32(src,tmp,numPrimitives,singleThreadThreshold);
+          sortMortonCodes(src,tmp,numPrimitives,singleThreadThreshold);
 
           /* build BVH */
           const ReductionTy root = recurse(1, range<unsigned>(0,(unsigned)numPrimitives), nullptr, true);
@@ -453,7 +570,7 @@ namespace embree
         ProgressMonitor& progressMonitor;
 
       public:
-        BuildPrim* morton;
+        BuildPrimTy* morton;
       };
 
 
@@ -464,7 +581,8 @@ namespace embree
         typename SetBoundsFunc,
         typename CreateLeafFunc,
         typename CalculateBoundsFunc,
-        typename ProgressMonitor>
+        typename ProgressMonitor,
+        typename BuildPrimTy>
 
         static ReductionTy build(CreateAllocFunc createAllocator,
                                  CreateNodeFunc createNode,
@@ -472,8 +590,8 @@ namespace embree
                                  CreateLeafFunc createLeaf,
                                  CalculateBoundsFunc calculateBounds,
                                  ProgressMonitor progressMonitor,
-                                 BuildPrim* src,
-                                 BuildPrim* tmp,
+                                 BuildPrimTy* src,
+                                 BuildPrimTy* tmp,
                                  size_t numPrimitives,
                                  const Settings& settings)
         {
@@ -485,7 +603,8 @@ namespace embree
             SetBoundsFunc,
             CreateLeafFunc,
             CalculateBoundsFunc,
-            ProgressMonitor> Builder;
+            ProgressMonitor,
+            BuildPrimTy> Builder;
 
           Builder builder(createAllocator,
                           createNode,
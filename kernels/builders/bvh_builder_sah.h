@@ -29,12 +29,12 @@ namespace embree
         /*! default settings */
         Settings ()
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7),
-          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf) {}
+          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf), rayDistribution(nullptr), geomWeights(nullptr), commitStats(nullptr) {}
 
         /*! initialize settings from API settings */
         Settings (const RTCBuildArguments& settings)
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7),
-          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf)
+          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf), rayDistribution(nullptr), geomWeights(nullptr), commitStats(nullptr)
         {
           if (RTC_BUILD_ARGUMENTS_HAS(settings,maxBranchingFactor)) branchingFactor = settings.maxBranchingFactor;
           if (RTC_BUILD_ARGUMENTS_HAS(settings,maxDepth          )) maxDepth        = settings.maxDepth;
@@ -49,7 +49,7 @@ namespace embree
 
         Settings (size_t sahBlockSize, size_t minLeafSize, size_t maxLeafSize, float travCost, float intCost, size_t singleThreadThreshold, size_t primrefarrayalloc = inf)
         : branchingFactor(2), maxDepth(32), logBlockSize(bsr(sahBlockSize)), minLeafSize(min(minLeafSize,maxLeafSize)), maxLeafSize(maxLeafSize),
-          travCost(travCost), intCost(intCost), singleThreadThreshold(singleThreadThreshold), primrefarrayalloc(primrefarrayalloc)
+          travCost(travCost), intCost(intCost), singleThreadThreshold(singleThreadThreshold), primrefarrayalloc(primrefarrayalloc), rayDistribution(nullptr), geomWeights(nullptr), commitStats(nullptr)
         {
         }
 
@@ -63,6 +63,9 @@ namespace embree
         float intCost;           //!< estimated cost of one primitive intersection
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
         size_t primrefarrayalloc;  //!< builder uses prim ref array to allocate nodes and leaves when a subtree of that size is finished
+        const RayDistribution* rayDistribution; //!< optional sampled ray distribution to guide split selection
+        const float* geomWeights;  //!< optional intersection cost weight per geometry ID
+        CommitStatistics* commitStats; //!< optional statistics receiving the binning and leaf creation times
       };
 
       /*! recursive state of builder */
@@ -466,7 +469,7 @@ namespace embree
                                  PrimRef* prims, const PrimInfo& pinfo,
                                  const Settings& settings)
       {
-        Heuristic heuristic(prims);
+        Heuristic heuristic(prims,settings.rayDistribution,pinfo.geomBounds,settings.geomWeights);
         return GeneralBVHBuilder::build<ReductionTy,Heuristic,Set,PrimRef>(
           heuristic,
           prims,
@@ -499,7 +502,7 @@ namespace embree
                                  PrimRef* prims, const PrimInfo& pinfo,
                                  const Settings& settings)
       {
-        Heuristic heuristic(prims);
+        Heuristic heuristic(prims,settings.rayDistribution,pinfo.geomBounds,settings.geomWeights);
         return GeneralBVHBuilder::build<ReductionTy,Heuristic,Set,PrimRef>(
           heuristic,
           prims,
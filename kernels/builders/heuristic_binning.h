@@ -110,6 +110,13 @@ namespace embree
         vfloat4 ofs,scale;        //!< linear function that maps to bin ID
       };
     
+    /*! surface area metric used by the standard SAH */
+    struct HalfAreaMetric
+    {
+      template<typename BBox>
+      __forceinline float operator() (const BBox& box) const { return expectedApproxHalfArea(box); }
+    };
+
     /*! stores all information to perform some split */
     template<size_t BINS>
       struct BinSplit
@@ -335,8 +342,10 @@ namespace embree
         return c;
       }
       
-      /*! finds the best split by scanning binning information */
-      __forceinline Split best(const BinMapping<BINS>& mapping, const size_t blocks_shift) const
+      /*! finds the best split by scanning binning information, the area metric
+       *  estimates the probability that a ray hits some bounds */
+      template<typename AreaMetric = HalfAreaMetric>
+      __forceinline Split best(const BinMapping<BINS>& mapping, const size_t blocks_shift, const AreaMetric& areaMetric = AreaMetric()) const
       {
 	/* sweep from right to left and compute parallel prefix of merged bounds */
 	vfloat4 rAreas[BINS];
@@ -346,9 +355,9 @@ namespace embree
         {
           count += counts(i);
           rCounts[i] = count;
-          bx.extend(bounds(i,0)); rAreas[i][0] = expectedApproxHalfArea(bx);
-          by.extend(bounds(i,1)); rAreas[i][1] = expectedApproxHalfArea(by);
-          bz.extend(bounds(i,2)); rAreas[i][2] = expectedApproxHalfArea(bz);
+          bx.extend(bounds(i,0)); rAreas[i][0] = areaMetric(bx);
+          by.extend(bounds(i,1)); rAreas[i][1] = areaMetric(by);
+          bz.extend(bounds(i,2)); rAreas[i][2] = areaMetric(bz);
           rAreas[i][3] = 0.0f;
         }
 	/* sweep from left to right and compute SAH */
@@ -358,9 +367,9 @@ namespace embree
 	for (size_t i=1; i<mapping.size(); i++, ii+=1)
         {
           count += counts(i-1);
-          bx.extend(bounds(i-1,0)); float Ax = expectedApproxHalfArea(bx);
-          by.extend(bounds(i-1,1)); float Ay = expectedApproxHalfArea(by);
-          bz.extend(bounds(i-1,2)); float Az = expectedApproxHalfArea(bz);
+          bx.extend(bounds(i-1,0)); float Ax = areaMetric(bx);
+          by.extend(bounds(i-1,1)); float Ay = areaMetric(by);
+          bz.extend(bounds(i-1,2)); float Az = areaMetric(bz);
           const vfloat4 lArea = vfloat4(Ax,Ay,Az,Az);
           const vfloat4 rArea = rAreas[i];
           const vuint4 lCount = (count     +blocks_add) >> (unsigned int)(blocks_shift); // if blocks_shift >=1 then lCount < 4B and could be represented with an vint4, which would allow for faster vfloat4 conversions.
@@ -500,6 +509,136 @@ namespace embree
       BBox _bounds[BINS][3]; //!< geometry bounds for each bin in each dimension
       vuint4   _counts[BINS];    //!< counts number of primitives that map into the bins
     };
+
+    /*! binning information that additionally accumulates a per
+     *  primitive intersection cost weight, such that the SAH can
+     *  isolate expensive primitives into separate subtrees */
+    template<size_t BINS, typename PrimRef, typename BBox>
+      struct __aligned(64) WeightedBinInfoT : public BinInfoT<BINS,PrimRef,BBox>
+    {
+      typedef BinInfoT<BINS,PrimRef,BBox> Base;
+      typedef BinSplit<BINS> Split;
+      using Base::bounds;
+      using Base::counts;
+
+      __forceinline WeightedBinInfoT() {
+      }
+
+      __forceinline WeightedBinInfoT(EmptyTy)
+        : Base(empty)
+      {
+        for (size_t i=0; i<BINS; i++)
+          weights(i) = vfloat4(zero);
+      }
+
+      /*! bin access function */
+      __forceinline vfloat4 &weights(const size_t binID)             { return _weights[binID]; }
+      __forceinline const vfloat4 &weights(const size_t binID) const { return _weights[binID]; }
+
+      /*! bins an array of primitives */
+      template<typename Weight>
+        __forceinline void bin (const PrimRef* prims, size_t N, const BinMapping<BINS>& mapping, const Weight& weight)
+      {
+        for (size_t i=0; i<N; i++)
+        {
+          BBox prim; Vec3fa center;
+          prims[i].binBoundsAndCenter(prim,center);
+          const vint4 bin = (vint4)mapping.bin(center);
+          const unsigned int s = (unsigned int)prims[i].size();
+          const float w = weight(prims[i]);
+
+          const int b0 = extract<0>(bin); counts(b0,0)+=s; bounds(b0,0).extend(prim); weights(b0)[0] += w;
+          const int b1 = extract<1>(bin); counts(b1,1)+=s; bounds(b1,1).extend(prim); weights(b1)[1] += w;
+          const int b2 = extract<2>(bin); counts(b2,2)+=s; bounds(b2,2).extend(prim); weights(b2)[2] += w;
+        }
+      }
+
+      template<typename Weight>
+        __forceinline void bin(const PrimRef* prims, size_t begin, size_t end, const BinMapping<BINS>& mapping, const Weight& weight) {
+        bin(prims+begin,end-begin,mapping,weight);
+      }
+
+      /*! merges in other binning information */
+      __forceinline void merge (const WeightedBinInfoT& other, size_t numBins)
+      {
+        Base::merge(other,numBins);
+        for (size_t i=0; i<numBins; i++)
+          weights(i) += other.weights(i);
+      }
+
+      /*! finds the best split by scanning binning information, the
+       *  cost of each side is scaled by its average primitive weight
+       *  relative to the average weight of all primitives */
+      __forceinline Split best(const BinMapping<BINS>& mapping, const size_t blocks_shift) const
+      {
+	/* sweep from right to left and compute parallel prefix of merged bounds */
+	vfloat4 rAreas[BINS];
+	vuint4 rCounts[BINS];
+	vfloat4 rWeights[BINS];
+	vuint4 count = 0; vfloat4 weight = 0.0f; BBox bx = empty; BBox by = empty; BBox bz = empty;
+	for (size_t i=mapping.size()-1; i>0; i--)
+        {
+          count += counts(i);
+          weight += weights(i);
+          rCounts[i] = count;
+          rWeights[i] = weight;
+          bx.extend(bounds(i,0)); rAreas[i][0] = expectedApproxHalfArea(bx);
+          by.extend(bounds(i,1)); rAreas[i][1] = expectedApproxHalfArea(by);
+          bz.extend(bounds(i,2)); rAreas[i][2] = expectedApproxHalfArea(bz);
+          rAreas[i][3] = 0.0f;
+        }
+        const float totalCount = float(count[0]+counts(0)[0]);
+        const float totalWeight = weight[0]+weights(0)[0];
+        const float rcpMeanWeight = totalWeight > 0.0f ? totalCount/totalWeight : 1.0f;
+
+	/* sweep from left to right and compute SAH */
+	vuint4 blocks_add = (1 << blocks_shift)-1;
+	vuint4 ii = 1; vfloat4 vbestSAH = pos_inf; vuint4 vbestPos = 0;
+	count = 0; weight = 0.0f; bx = empty; by = empty; bz = empty;
+	for (size_t i=1; i<mapping.size(); i++, ii+=1)
+        {
+          count += counts(i-1);
+          weight += weights(i-1);
+          bx.extend(bounds(i-1,0)); float Ax = expectedApproxHalfArea(bx);
+          by.extend(bounds(i-1,1)); float Ay = expectedApproxHalfArea(by);
+          bz.extend(bounds(i-1,2)); float Az = expectedApproxHalfArea(bz);
+          const vfloat4 lArea = vfloat4(Ax,Ay,Az,Az);
+          const vfloat4 rArea = rAreas[i];
+          const vfloat4 lPrims = vfloat4(count);
+          const vfloat4 rPrims = vfloat4(rCounts[i]);
+          const vfloat4 lMeanWeight = select(lPrims > 0.0f,weight     /lPrims,vfloat4(zero));
+          const vfloat4 rMeanWeight = select(rPrims > 0.0f,rWeights[i]/rPrims,vfloat4(zero));
+          const vfloat4 lCount = vfloat4((count     +blocks_add) >> (unsigned int)(blocks_shift));
+          const vfloat4 rCount = vfloat4((rCounts[i]+blocks_add) >> (unsigned int)(blocks_shift));
+          const vfloat4 sah = madd(lArea*lCount,lMeanWeight,rArea*rCount*rMeanWeight)*rcpMeanWeight;
+
+          vbestPos = select(sah < vbestSAH,ii ,vbestPos);
+          vbestSAH = select(sah < vbestSAH,sah,vbestSAH);
+        }
+
+	/* find best dimension */
+	float bestSAH = inf;
+	int   bestDim = -1;
+	int   bestPos = 0;
+	for (int dim=0; dim<3; dim++)
+        {
+          /* ignore zero sized dimensions */
+          if (unlikely(mapping.invalid(dim)))
+            continue;
+
+          /* test if this is a better dimension */
+          if (vbestSAH[dim] < bestSAH && vbestPos[dim] != 0) {
+            bestDim = dim;
+            bestPos = vbestPos[dim];
+            bestSAH = vbestSAH[dim];
+          }
+        }
+	return Split(bestSAH,bestDim,bestPos,mapping);
+      }
+
+    private:
+      vfloat4 _weights[BINS];    //!< accumulated primitive weights of the bins
+    };
   }
 
   template<typename BinInfoT, typename BinMapping, typename PrimRef>
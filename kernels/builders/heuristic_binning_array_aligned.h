@@ -4,6 +4,7 @@
 #pragma once
 
 #include "heuristic_binning.h"
+#include "heuristic_ray_distribution.h"
 
 namespace embree
 {
@@ -79,6 +80,7 @@ namespace embree
       {
         typedef BinSplit<BINS> Split;
         typedef BinInfoT<BINS,PrimRef,BBox3fa> Binner;
+        typedef WeightedBinInfoT<BINS,PrimRef,BBox3fa> WeightedBinner;
         typedef range<size_t> Set;
 
         static const size_t PARALLEL_THRESHOLD = 3 * 1024;
@@ -86,11 +88,15 @@ namespace embree
         static const size_t PARALLEL_PARTITION_BLOCK_SIZE = 128;
 
         __forceinline HeuristicArrayBinningSAH ()
-          : prims(nullptr) {}
+          : prims(nullptr), rays(nullptr), geomWeights(nullptr) {}
 
         /*! remember prim array */
         __forceinline HeuristicArrayBinningSAH (PrimRef* prims)
-          : prims(prims) {}
+          : prims(prims), rays(nullptr), geomWeights(nullptr) {}
+
+        /*! remember prim array, sampled ray distribution, and per geometry intersection cost weights to guide split selection */
+        __forceinline HeuristicArrayBinningSAH (PrimRef* prims, const RayDistribution* rays, const BBox3fa& rootBounds, const float* geomWeights = nullptr)
+          : prims(prims), rays(rays), rootBounds(rootBounds), geomWeights(geomWeights) {}
 
         /*! finds the best split */
         __noinline const Split find(const PrimInfoRange& pinfo, const size_t logBlockSize)
@@ -104,9 +110,26 @@ namespace embree
         template<bool parallel>
         __forceinline const Split find_template(const PrimInfoRange& pinfo, const size_t logBlockSize)
         {
+          if (unlikely(geomWeights != nullptr))
+            return find_weighted_template<parallel>(pinfo,logBlockSize);
+
           Binner binner(empty);
           const BinMapping<BINS> mapping(pinfo);
           bin_serial_or_parallel<parallel>(binner,prims,pinfo.begin(),pinfo.end(),PARALLEL_FIND_BLOCK_SIZE,mapping);
+          if (unlikely(RayDistributionMetric::enabled(rays,pinfo.size())))
+            return binner.best(mapping,logBlockSize,RayDistributionMetric(*rays,rootBounds));
+          return binner.best(mapping,logBlockSize);
+        }
+
+        /*! finds the best split weighting primitives by the intersection cost of their geometry */
+        template<bool parallel>
+        __forceinline const Split find_weighted_template(const PrimInfoRange& pinfo, const size_t logBlockSize)
+        {
+          WeightedBinner binner(empty);
+          const BinMapping<BINS> mapping(pinfo);
+          const float* weights = geomWeights;
+          auto getWeight = [weights] (const PrimRef& prim) { return weights[prim.geomID()]; };
+          bin_serial_or_parallel<parallel>(binner,prims,pinfo.begin(),pinfo.end(),PARALLEL_FIND_BLOCK_SIZE,mapping,getWeight);
           return binner.best(mapping,logBlockSize);
         }
 
@@ -200,6 +223,9 @@ namespace embree
 
       private:
         PrimRef* const prims;
+        const RayDistribution* rays;
+        BBox3fa rootBounds;
+        const float* geomWeights;
       };
 
 #if !defined(RTHWIF_STANDALONE)
@@ -0,0 +1,93 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../common/default.h"
+
+namespace embree
+{
+  /*! sample of the expected ray distribution that guides the BVH build */
+  struct RayDistribution
+  {
+    RayDistribution ()
+      : numRays(0), weight(0.0f) {}
+
+    /*! returns true if no ray distribution got specified */
+    __forceinline bool empty() const { return numRays == 0 || weight == 0.0f; }
+
+    /*! returns number of sampled rays */
+    __forceinline size_t size() const { return numRays; }
+
+  public:
+    size_t numRays;        //!< number of sampled rays
+    avector<float> rays;   //!< blocks of 4 rays in SOA layout storing org.x/y/z, rdir.x/y/z, tnear, and tfar
+    float weight;          //!< fraction of rays expected to follow the sampled distribution
+  };
+
+  namespace isa
+  {
+    /*! The ray distribution heuristic replaces the surface area of
+     *  some bounds by a blend of its surface area (modelling uniformly
+     *  distributed rays) and the fraction of sampled rays hitting the
+     *  bounds, scaled to the surface area of the root bounds. */
+    struct RayDistributionMetric
+    {
+      /*! evaluating the metric requires testing all sampled rays, thus
+       *  we only use it for large nodes where the cost is amortized by
+       *  binning the primitives */
+      static const size_t MIN_PRIMITIVES_PER_RAY = 16;
+
+      __forceinline RayDistributionMetric (const RayDistribution& rays, const BBox3fa& rootBounds)
+        : rays(rays), rootArea(expectedApproxHalfArea(rootBounds)), rcpNumRays(1.0f/float(rays.size())) {}
+
+      /*! tests if the metric should get used for a node with N primitives */
+      static __forceinline bool enabled(const RayDistribution* rays, size_t N) {
+        return rays && !rays->empty() && N >= MIN_PRIMITIVES_PER_RAY*rays->size();
+      }
+
+      /*! returns the fraction of sampled rays hitting the bounds */
+      __forceinline float hitRate(const BBox3fa& box) const
+      {
+        const vfloat4 lower_x(box.lower.x), lower_y(box.lower.y), lower_z(box.lower.z);
+        const vfloat4 upper_x(box.upper.x), upper_y(box.upper.y), upper_z(box.upper.z);
+
+        size_t hits = 0;
+        const float* ptr = rays.rays.data();
+        for (size_t i=0; i<rays.rays.size(); i+=32)
+        {
+          const vfloat4 org_x  = vfloat4::loadu(ptr+i+ 0);
+          const vfloat4 org_y  = vfloat4::loadu(ptr+i+ 4);
+          const vfloat4 org_z  = vfloat4::loadu(ptr+i+ 8);
+          const vfloat4 rdir_x = vfloat4::loadu(ptr+i+12);
+          const vfloat4 rdir_y = vfloat4::loadu(ptr+i+16);
+          const vfloat4 rdir_z = vfloat4::loadu(ptr+i+20);
+          const vfloat4 tnear  = vfloat4::loadu(ptr+i+24);
+          const vfloat4 tfar   = vfloat4::loadu(ptr+i+28);
+
+          const vfloat4 t0x = (lower_x-org_x)*rdir_x, t1x = (upper_x-org_x)*rdir_x;
+          const vfloat4 t0y = (lower_y-org_y)*rdir_y, t1y = (upper_y-org_y)*rdir_y;
+          const vfloat4 t0z = (lower_z-org_z)*rdir_z, t1z = (upper_z-org_z)*rdir_z;
+          const vfloat4 tNear = max(max(min(t0x,t1x),min(t0y,t1y)),max(min(t0z,t1z),tnear));
+          const vfloat4 tFar  = min(min(max(t0x,t1x),max(t0y,t1y)),min(max(t0z,t1z),tfar));
+          hits += popcnt(tNear <= tFar);
+        }
+        return float(hits)*rcpNumRays;
+      }
+
+      __forceinline float operator() (const BBox3fa& box) const
+      {
+        const float area = expectedApproxHalfArea(box);
+
+        /* empty bounds have to keep their infinite area to get rejected as split candidates */
+        if (unlikely(box.empty())) return area;
+        return (1.0f-rays.weight)*area + rays.weight*rootArea*hitRate(box);
+      }
+
+    private:
+      const RayDistribution& rays;
+      const float rootArea;
+      const float rcpNumRays;
+    };
+  }
+}
@@ -153,9 +153,12 @@ namespace embree
       return pinfo;
     }
 
-    template<typename Mesh>
-    size_t createMortonCodeArray(Mesh* mesh, mvector<BVHBuilderMorton::BuildPrim>& morton, BuildProgressMonitor& progressMonitor)
+    template<typename Mesh, typename BuildPrim>
+    size_t createMortonCodeArray(Mesh* mesh, mvector<BuildPrim>& morton, BuildProgressMonitor& progressMonitor)
     {
+      typedef typename BuildPrim::Mapping MortonCodeMapping;
+      typedef typename BuildPrim::Generator MortonCodeGenerator;
+
       size_t numPrimitives = morton.size();
 
       /* compute scene bounds */
@@ -186,9 +189,9 @@ namespace embree
       if (likely(numPrimitivesGen == numPrimitives))
       {
         /* fast path if all primitives were valid */
-        BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
+        MortonCodeMapping mapping(centBounds);
         parallel_for( size_t(0), numPrimitives, size_t(1024), [&](const range<size_t>& r) -> void {
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
+            MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
             for (size_t j=r.begin(); j<r.end(); j++)
               generator(mesh->bounds(j),unsigned(j));
           });
@@ -197,10 +200,10 @@ namespace embree
       {
         /* slow path, fallback in case some primitives were invalid */
         ParallelPrefixSumState<size_t> pstate;
-        BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
+        MortonCodeMapping mapping(centBounds);
         parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
             size_t num = 0;
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
+            MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
             for (size_t j=r.begin(); j<r.end(); j++)
             {
               BBox3fa bounds = empty;
@@ -213,7 +216,7 @@ namespace embree
         
         parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
             size_t num = 0;
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[base]);
+            MortonCodeGenerator generator(mapping,&morton.data()[base]);
             for (size_t j=r.begin(); j<r.end(); j++)
             {
               BBox3fa bounds = empty;
@@ -351,9 +354,14 @@ namespace embree
     // ====================================================================================================
     
     IF_ENABLED_TRIS (template size_t createMortonCodeArray<TriangleMesh>(TriangleMesh* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_TRIS (template size_t createMortonCodeArray<TriangleMesh>(TriangleMesh* mesh COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_QUADS(template size_t createMortonCodeArray<QuadMesh>(QuadMesh* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_QUADS(template size_t createMortonCodeArray<QuadMesh>(QuadMesh* mesh COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_USER (template size_t createMortonCodeArray<UserGeometry>(UserGeometry* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_USER (template size_t createMortonCodeArray<UserGeometry>(UserGeometry* mesh COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_INSTANCE (template size_t createMortonCodeArray<Instance>(Instance* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_INSTANCE (template size_t createMortonCodeArray<Instance>(Instance* mesh COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_INSTANCE_ARRAY (template size_t createMortonCodeArray<InstanceArray>(InstanceArray* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_INSTANCE_ARRAY (template size_t createMortonCodeArray<InstanceArray>(InstanceArray* mesh COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
   }
 }
@@ -24,8 +24,8 @@ namespace embree
 
     PrimInfoMB createPrimRefArrayMSMBlur(Scene* scene, Geometry::GTypeMask types, size_t numPrimitives, mvector<PrimRefMB>& prims, mvector<SubGridBuildData>& sgrids, BuildProgressMonitor& progressMonitor, BBox1f t0t1 = BBox1f(0.0f,1.0f));
 
-    template<typename Mesh>
-      size_t createMortonCodeArray(Mesh* mesh, mvector<BVHBuilderMorton::BuildPrim>& morton, BuildProgressMonitor& progressMonitor);
+    template<typename Mesh, typename BuildPrim>
+      size_t createMortonCodeArray(Mesh* mesh, mvector<BuildPrim>& morton, BuildProgressMonitor& progressMonitor);
 
     /* special variants for grids */
     PrimInfo createPrimRefArrayGrids(Scene* scene, mvector<PrimRef>& prims, mvector<SubGridBuildData>& sgrids); // FIXME: remove
@@ -98,6 +98,44 @@ namespace embree
       float extend;
     };
 
+    /*! settings to tune the pre-splitting heuristic */
+    struct PresplitSettings
+    {
+      enum Priority
+      {
+        PRIORITY_AREA   = 0, //!< prioritizes primitives by the difference of bounds area and projected primitive area
+        PRIORITY_VOLUME = 1  //!< prioritizes primitives whose bounds volume greatly exceeds their true extent (e.g. diagonal triangles)
+      };
+
+      __forceinline PresplitSettings ()
+        : priority(PRIORITY_AREA), splitPosWeight(PRIORITY_SPLIT_POS_WEIGHT), maxSplitsLog(MAX_PRESPLITS_PER_PRIMITIVE_LOG) {}
+
+      __forceinline PresplitSettings (Priority priority, float splitPosWeight, unsigned int maxSplitsLog)
+        : priority(priority), splitPosWeight(splitPosWeight), maxSplitsLog(min(maxSplitsLog,(unsigned int)MAX_PRESPLITS_PER_PRIMITIVE_LOG)) {}
+
+    public:
+      Priority priority;          //!< metric used to distribute the split budget
+      float splitPosWeight;       //!< weight favouring splits at coarse levels of the splitting grid
+      unsigned int maxSplitsLog;  //!< maximally 2^maxSplitsLog sub-primitives per primitive
+    };
+
+    /*! statistics about the pre-splitting pass */
+    struct PresplitStatistics
+    {
+      __forceinline PresplitStatistics ()
+        : numPrimitives(0), numSplitPrimitives(0), numSubPrimitives(0) {}
+
+      friend inline std::ostream& operator<<(std::ostream& cout, const PresplitStatistics& stats) {
+        return cout << "presplits: " << stats.numSplitPrimitives << " of " << stats.numPrimitives << " primitives split, "
+                    << stats.numSubPrimitives << " sub-primitives added (" << 100.0*double(stats.numSubPrimitives)/double(max(stats.numPrimitives,size_t(1))) << "%)";
+      }
+
+    public:
+      size_t numPrimitives;       //!< number of primitives before pre-splitting
+      size_t numSplitPrimitives;  //!< number of primitives that got split
+      size_t numSubPrimitives;    //!< number of additional primitives generated by splitting
+    };
+
     struct PresplitItem
     {
       union {
@@ -111,16 +149,32 @@ namespace embree
       }
 
       template<typename ProjectedPrimitiveAreaFunc>
-      __forceinline static float compute_priority(const ProjectedPrimitiveAreaFunc& primitiveArea, const PrimRef &ref, const Vec2i &mc)
+      __forceinline static float compute_priority(const ProjectedPrimitiveAreaFunc& primitiveArea, const PrimRef &ref, const Vec2i &mc, const PresplitSettings& settings = PresplitSettings())
       {
 	const float area_aabb  = area(ref.bounds());
 	const float area_prim  = primitiveArea(ref);
         if (area_prim == 0.0f) return 0.0f;
         const unsigned int diff = 31 - lzcnt(mc.x^mc.y);
-        //assert(area_prim <= area_aabb); // may trigger due to numerical issues 
-        const float area_diff = max(0.0f, area_aabb - area_prim);
+        
+        float area_diff = 0.0f;
+        if (settings.priority == PresplitSettings::PRIORITY_VOLUME)
+        {
+          /* flat primitives aligned to an axis have zero bounds volume, diagonal
+           * ones fill their bounds in all three dimensions, thus we scale the bounds
+           * area by the cube root of the volume relative to the largest extent */
+          const Vec3fa size = ref.bounds().size();
+          const float extent = reduce_max(size);
+          if (extent == 0.0f) return 0.0f;
+          const float volume = size.x*size.y*size.z;
+          area_diff = area_aabb * min(1.0f, powf(volume,1.0f/3.0f) / extent);
+        }
+        else
+        {
+          //assert(area_prim <= area_aabb); // may trigger due to numerical issues 
+          area_diff = max(0.0f, area_aabb - area_prim);
+        }
         //const float priority = powf(area_diff * powf(PRIORITY_SPLIT_POS_WEIGHT,(float)diff),1.0f/4.0f);   
-        const float priority = sqrtf(sqrtf( area_diff * powf(PRIORITY_SPLIT_POS_WEIGHT,(float)diff) ));
+        const float priority = sqrtf(sqrtf( area_diff * powf(settings.splitPosWeight,(float)diff) ));
         //const float priority = sqrtf(sqrtf( area_diff ) );
         //const float priority = sqrtfarea_diff;
         //const float priority = area_diff; // 104 fps !!!!!!!!!!
@@ -255,7 +309,9 @@ namespace embree
                                          PrimVector& prims,
                                          const PrimInfo& pinfo,
                                          const SplitPrimitiveFunc& splitPrimitive,
-                                         const ProjectedPrimitiveAreaFunc& primitiveArea)
+                                         const ProjectedPrimitiveAreaFunc& primitiveArea,
+                                         const PresplitSettings& settings = PresplitSettings(),
+                                         PresplitStatistics* stats = nullptr)
     {
       static const size_t MIN_STEP_SIZE = 128;
 
@@ -268,6 +324,11 @@ namespace embree
       avector<PresplitItem> preSplitItem0(numPrimitivesExt);
       avector<PresplitItem> preSplitItem1(numPrimitivesExt);
 
+      if (stats) {
+        *stats = PresplitStatistics();
+        stats->numPrimitives = numPrimitives;
+      }
+
       /* compute grid */
       SplittingGrid grid(pinfo.geomBounds);
       
@@ -279,13 +340,17 @@ namespace embree
             preSplitItem0[i].index = (unsigned int)i;
             const Vec2i mc = grid.computeMC(prims[i]);
             /* if all bits are equal then we cannot split */
-            preSplitItem0[i].priority = (mc.x != mc.y) ? PresplitItem::compute_priority(primitiveArea,prims[i],mc) : 0.0f;    
+            preSplitItem0[i].priority = (mc.x != mc.y) ? PresplitItem::compute_priority(primitiveArea,prims[i],mc,settings) : 0.0f;    
             /* FIXME: sum undeterministic */
             sum += preSplitItem0[i].priority;
           }
           return sum;
         },[](const float& a, const float& b) -> float { return a+b; });
 
+      /* nothing worth splitting */
+      if (psum <= 0.0f)
+        return pinfo;
+
       /* compute number of splits per primitive */
       const float inv_psum = 1.0f / psum;
       parallel_for( size_t(0), numPrimitives, size_t(MIN_STEP_SIZE), [&](const range<size_t>& r) -> void {
@@ -303,7 +368,7 @@ namespace embree
             }
             
             //preSplitItem0[i].data = max(min(ceilf(rel_p),(float)MAX_PRESPLITS_PER_PRIMITIVE),1.0f);
-            preSplitItem0[i].data = max(min(ceilf(logf(rel_p)/logf(2.0f)),(float)MAX_PRESPLITS_PER_PRIMITIVE_LOG),1.0f);
+            preSplitItem0[i].data = max(min(ceilf(logf(rel_p)/logf(2.0f)),(float)settings.maxSplitsLog),1.0f);
             preSplitItem0[i].data = 1 << preSplitItem0[i].data;
             assert(preSplitItem0[i].data <= MAX_PRESPLITS_PER_PRIMITIVE);
           }
@@ -404,6 +469,11 @@ namespace embree
       });
 
       numPrimitives += offset;
+
+      if (stats) {
+        stats->numSplitPrimitives = numPrimitivesToSplit;
+        stats->numSubPrimitives = offset;
+      }
                 
       /* recompute centroid bounding boxes */
       const PrimInfo pinfo1 = parallel_reduce(size_t(0),numPrimitives,size_t(MIN_STEP_SIZE),PrimInfo(empty),[&] (const range<size_t>& r) -> PrimInfo {
@@ -421,12 +491,14 @@ namespace embree
 #if !defined(RTHWIF_STANDALONE)
     
      template<typename Mesh, typename SplitterFactory>    
-      PrimInfo createPrimRefArray_presplit(Scene* scene, Geometry::GTypeMask types, bool mblur, size_t numPrimRefs, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
+      PrimInfo createPrimRefArray_presplit(Scene* scene, Geometry::GTypeMask types, bool mblur, size_t numPrimRefs, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor,
+                                           const PresplitSettings& settings = PresplitSettings(), PresplitStatistics* stats = nullptr, CommitStatistics* commitStats = nullptr)
     {
       ParallelForForPrefixSumState<PrimInfo> pstate;
       Scene::Iterator2 iter(scene,types,mblur);
 
       /* first try */
+      CommitPhaseTimer primrefTimer(commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numPrimRefs);
       progressMonitor(0);
       pstate.init(iter,size_t(1024));
       PrimInfo pinfo = parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, size_t geomID) -> PrimInfo {
@@ -441,7 +513,7 @@ namespace embree
 	      return mesh->createPrimRefArray(prims,r,base.size(),(unsigned)geomID);
 	    }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
 	}
-
+      primrefTimer.stop();
 
       SplitterFactory Splitter(scene);
         
@@ -461,7 +533,8 @@ namespace embree
         return ((Mesh*)scene->get(geomID))->projectedPrimitiveArea(primID);
       };
       
-      return createPrimRefArray_presplit(numPrimRefs,prims,pinfo,split_primitive,primitiveArea);
+      CommitPhaseTimer presplitTimer(commitStats,RTC_BUILD_PHASE_PRESPLIT,pinfo.size());
+      return createPrimRefArray_presplit(numPrimRefs,prims,pinfo,split_primitive,primitiveArea,settings,stats);
     }
 #endif 
   }
@@ -11,11 +11,13 @@ namespace embree
     typename BVHN<N>::NodeRef BVHNBuilderVirtual<N>::BVHNBuilderV::build(FastAllocator* allocator, BuildProgressMonitor& progressFunc, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings)
     {
       auto createLeafFunc = [&] (const PrimRef* prims, const range<size_t>& set, const Allocator& alloc) -> NodeRef {
+        CommitPhaseTimer timer(settings.commitStats,RTC_BUILD_PHASE_LEAF_CREATION,set.size());
         return createLeaf(prims,set,alloc);
       };
       
       settings.branchingFactor = N;
       settings.maxDepth = BVH::maxBuildDepthLeaf;
+      CommitPhaseTimer timer(settings.commitStats,RTC_BUILD_PHASE_BINNING,pinfo.size());
       return BVHBuilderBinnedSAH::build<NodeRef>
         (FastAllocator::Create(allocator),typename BVH::AABBNode::Create2(),typename BVH::AABBNode::Set3(allocator,prims),createLeafFunc,progressFunc,prims,pinfo,settings);
     }
@@ -25,11 +27,13 @@ namespace embree
     typename BVHN<N>::NodeRef BVHNBuilderQuantizedVirtual<N>::BVHNBuilderV::build(FastAllocator* allocator, BuildProgressMonitor& progressFunc, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings)
     {
       auto createLeafFunc = [&] (const PrimRef* prims, const range<size_t>& set, const Allocator& alloc) -> NodeRef {
+        CommitPhaseTimer timer(settings.commitStats,RTC_BUILD_PHASE_LEAF_CREATION,set.size());
         return createLeaf(prims,set,alloc);
       };
             
       settings.branchingFactor = N;
       settings.maxDepth = BVH::maxBuildDepthLeaf;
+      CommitPhaseTimer timer(settings.commitStats,RTC_BUILD_PHASE_BINNING,pinfo.size());
       return BVHBuilderBinnedSAH::build<NodeRef>
         (FastAllocator::Create(allocator),typename BVH::QuantizedNode::Create2(),typename BVH::QuantizedNode::Set2(),createLeafFunc,progressFunc,prims,pinfo,settings);
     }
@@ -38,11 +42,13 @@ namespace embree
     typename BVHN<N>::NodeRecordMB BVHNBuilderMblurVirtual<N>::BVHNBuilderV::build(FastAllocator* allocator, BuildProgressMonitor& progressFunc, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings, const BBox1f& timeRange)
     {
       auto createLeafFunc = [&] (const PrimRef* prims, const range<size_t>& set, const Allocator& alloc) -> NodeRecordMB {
+        CommitPhaseTimer timer(settings.commitStats,RTC_BUILD_PHASE_LEAF_CREATION,set.size());
         return createLeaf(prims,set,alloc);
       };
 
       settings.branchingFactor = N;
       settings.maxDepth = BVH::maxBuildDepthLeaf;
+      CommitPhaseTimer timer(settings.commitStats,RTC_BUILD_PHASE_BINNING,pinfo.size());
       return BVHBuilderBinnedSAH::build<NodeRecordMB>
         (FastAllocator::Create(allocator),typename BVH::AABBNodeMB::Create(),typename BVH::AABBNodeMB::SetTimeRange(timeRange),createLeafFunc,progressFunc,prims,pinfo,settings);
     }
@@ -3,6 +3,8 @@
 
 #include "../builders/bvh_builder_hair.h"
 #include "../builders/primrefgen.h"
+#include "../../common/algorithms/parallel_prefix_sum.h"
+#include "../../common/algorithms/parallel_reduce.h"
 
 #include "../geometry/pointi.h"
 #include "../geometry/linei.h"
@@ -28,6 +30,63 @@ namespace embree
 
       BVHNHairBuilderSAH (BVH* bvh, Scene* scene)
         : bvh(bvh), scene(scene), prims(scene->device,0) {}
+
+      /*! splits round curve segments that bend by more than the hair
+       *  subdivision angle into up to 8 sub-segments, the sub-segment is
+       *  encoded into the upper bits of the primID of the primref */
+      PrimInfo subdivideCurveSegments(const PrimInfo& pinfo, const float maxAngle)
+      {
+        const size_t numPrims = pinfo.size();
+        mvector<unsigned char> levels(scene->device,numPrims);
+
+        /* first pass calculates subdivision levels */
+        ParallelPrefixSumState<size_t> pstate;
+        const size_t numSubPrims = parallel_prefix_sum( pstate, size_t(0), numPrims, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
+            size_t n = 0;
+            for (size_t i=r.begin(); i<r.end(); i++)
+            {
+              const Geometry* geom = scene->get(prims[i].geomID());
+              unsigned int level = 0;
+              if ((geom->getTypeMask() & Geometry::MTY_CURVE4) && ((const CurveGeometry*)geom)->subSegments)
+                level = ((const CurveGeometry*)geom)->subSegmentLevel(prims[i].primID(),maxAngle);
+              levels[i] = (unsigned char) level;
+              n += size_t(1) << level;
+            }
+            return n;
+          }, std::plus<size_t>());
+
+        if (numSubPrims == numPrims)
+          return pinfo;
+
+        /* second pass creates primrefs for all sub-segments */
+        mvector<PrimRef> subPrims(scene->device,numSubPrims);
+        parallel_prefix_sum( pstate, size_t(0), numPrims, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
+            size_t k = base;
+            for (size_t i=r.begin(); i<r.end(); i++)
+            {
+              const unsigned int level = levels[i];
+              if (level == 0) {
+                subPrims[k++] = prims[i];
+                continue;
+              }
+              const unsigned int geomID = prims[i].geomID();
+              const unsigned int primID = prims[i].primID();
+              const Geometry* geom = scene->get(geomID);
+              for (unsigned int j=0; j<(1u << level); j++) {
+                const unsigned int segment = CurveGeometry::encodeSubSegment(primID,level,j);
+                subPrims[k++] = PrimRef(geom->vbounds(segment),geomID,segment);
+              }
+            }
+            return k-base;
+          }, std::plus<size_t>());
+        prims = std::move(subPrims);
+
+        return parallel_reduce(size_t(0), numSubPrims, size_t(1024), size_t(1024), PrimInfo(empty), [&](const range<size_t>& r) -> PrimInfo {
+            PrimInfo pinfo(empty);
+            for (size_t i=r.begin(); i<r.end(); i++) pinfo.add_center2(prims[i]);
+            return pinfo;
+          }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+      }
       
       void build() 
       {
@@ -45,9 +104,18 @@ namespace embree
 
         double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "HairBuilderSAH");
 
+        CommitStatistics* commitStats = scene->getCommitStatistics();
+        bvh->alloc.setCommitStatistics(commitStats);
+
         /* create primref array */
         prims.resize(numPrimitives);
-        const PrimInfo pinfo = createPrimRefArray(scene,Geometry::MTY_CURVES,false,numPrimitives,prims,scene->progressInterface);
+        CommitPhaseTimer primrefTimer(commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numPrimitives);
+        PrimInfo pinfo = createPrimRefArray(scene,Geometry::MTY_CURVES,false,numPrimitives,prims,scene->progressInterface);
+
+        /* subdivide strongly bent curve segments */
+        if (scene->device->hair_subdivision_angle > 0.0f)
+          pinfo = subdivideCurveSegments(pinfo,deg2rad(scene->device->hair_subdivision_angle));
+        primrefTimer.stop();
 
         /* estimate acceleration structure size */
         const size_t node_bytes = pinfo.size()*sizeof(typename BVH::OBBNode)/(4*N);
@@ -60,7 +128,7 @@ namespace embree
         settings.logBlockSize = bsf(CurvePrimitive::max_size());
         settings.minLeafSize = CurvePrimitive::max_size();
         settings.maxLeafSize = CurvePrimitive::max_size();
-        settings.finished_range_threshold = numPrimitives/1000;
+        settings.finished_range_threshold = pinfo.size()/1000;
         if (settings.finished_range_threshold < 1000)
           settings.finished_range_threshold = inf;
 
@@ -70,6 +138,7 @@ namespace embree
           if (set.size() == 0)
             return BVH::emptyNode;
 
+          CommitPhaseTimer timer(commitStats,RTC_BUILD_PHASE_LEAF_CREATION,set.size());
           const unsigned int geomID0 = prims[set.begin()].geomID();
           if (scene->get(geomID0)->getTypeMask() & Geometry::MTY_POINTS)
             return PointPrimitive::createLeaf(bvh,prims,set,alloc);
@@ -88,6 +157,7 @@ namespace embree
           };
           
         /* build hierarchy */
+        CommitPhaseTimer binningTimer(commitStats,RTC_BUILD_PHASE_BINNING,pinfo.size());
         typename BVH::NodeRef root = BVHBuilderHair::build<NodeRef>
           (typename BVH::CreateAlloc(bvh),
            typename BVH::AABBNode::Create(),
@@ -97,6 +167,7 @@ namespace embree
            createLeaf,scene->progressInterface,
            reportFinishedRange,
            scene,prims.data(),pinfo,settings);
+        binningTimer.stop();
         
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         
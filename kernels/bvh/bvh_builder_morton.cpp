@@ -77,17 +77,17 @@ namespace embree
       }
     };
 
-    template<int N, typename Primitive>
+    template<int N, typename Primitive, typename BuildPrim>
     struct CreateMortonLeaf;
 
-    template<int N>
-    struct CreateMortonLeaf<N,Triangle4>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Triangle4,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
 
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -132,18 +132,18 @@ namespace embree
     
     private:
       TriangleMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
     
-    template<int N>
-    struct CreateMortonLeaf<N,Triangle4v>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Triangle4v,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -186,18 +186,18 @@ namespace embree
       }
     private:
       TriangleMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,Triangle4i>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Triangle4i,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -251,18 +251,18 @@ namespace embree
       }
     private:
       TriangleMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,Quad4v>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Quad4v,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (QuadMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (QuadMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -308,18 +308,18 @@ namespace embree
       }
     private:
       QuadMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,Object>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Object,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (UserGeometry* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (UserGeometry* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -352,18 +352,18 @@ namespace embree
       }
     private:
       UserGeometry* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,InstancePrimitive>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,InstancePrimitive,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (Instance* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (Instance* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -396,18 +396,18 @@ namespace embree
       }
     private:
       Instance* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,InstanceArrayPrimitive>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,InstanceArrayPrimitive,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (InstanceArray* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (InstanceArray* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
 
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -440,17 +440,17 @@ namespace embree
       }
     private:
       InstanceArray* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<typename Mesh>
+    template<typename Mesh, typename BuildPrim>
     struct CalculateMeshBounds
     {
       __forceinline CalculateMeshBounds (Mesh* mesh)
         : mesh(mesh) {}
       
-      __forceinline const BBox3fa operator() (const BVHBuilderMorton::BuildPrim& morton) {
+      __forceinline const BBox3fa operator() (const BuildPrim& morton) {
         return mesh->bounds(morton.index);
       }
       
@@ -469,10 +469,23 @@ namespace embree
     public:
       
       BVHNMeshBuilderMorton (BVH* bvh, Mesh* mesh, unsigned int geomID, const size_t minLeafSize, const size_t maxLeafSize, const size_t singleThreadThreshold = DEFAULT_SINGLE_THREAD_THRESHOLD)
-        : bvh(bvh), mesh(mesh), morton(bvh->device,0), settings(N,BVH::maxBuildDepth,minLeafSize,min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks),singleThreadThreshold), geomID_(geomID) {}
+        : bvh(bvh), mesh(mesh), morton(bvh->device,0), morton64(bvh->device,0), settings(N,BVH::maxBuildDepth,minLeafSize,min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks),singleThreadThreshold), geomID_(geomID) {}
       
       /* build function */
       void build() 
+      {
+        /* large extent scenes can request 63 bit morton codes through the device config */
+        if (bvh->device->morton_code_bits == 64) {
+          morton.clear();
+          build(morton64);
+        } else {
+          morton64.clear();
+          build(morton);
+        }
+      }
+
+      template<typename BuildPrim>
+      void build(mvector<BuildPrim>& morton)
       {
         /* we reset the allocator when the mesh size changed */
         if (mesh->numPrimitives != numPreviousPrimitives) {
@@ -491,23 +504,30 @@ namespace embree
         /* preallocate arrays */
         morton.resize(numPrimitives);
         size_t bytesEstimated = numPrimitives*sizeof(AABBNode)/(4*N) + size_t(1.2f*Primitive::blocks(numPrimitives)*sizeof(Primitive));
-        size_t bytesMortonCodes = numPrimitives*sizeof(BVHBuilderMorton::BuildPrim);
+        size_t bytesMortonCodes = numPrimitives*sizeof(BuildPrim);
         bytesEstimated = max(bytesEstimated,bytesMortonCodes); // the first allocation block is reused to sort the morton codes
         bvh->alloc.init(bytesMortonCodes,bytesMortonCodes,bytesEstimated);
 
+        CommitStatistics* commitStats = bvh->scene->getCommitStatistics();
+        bvh->alloc.setCommitStatistics(commitStats);
+
         /* create morton code array */
-        BVHBuilderMorton::BuildPrim* dest = (BVHBuilderMorton::BuildPrim*) bvh->alloc.specialAlloc(bytesMortonCodes);
+        BuildPrim* dest = (BuildPrim*) bvh->alloc.specialAlloc(bytesMortonCodes);
+        CommitPhaseTimer primrefTimer(commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numPrimitives);
         size_t numPrimitivesGen = createMortonCodeArray<Mesh>(mesh,morton,bvh->scene->progressInterface);
+        primrefTimer.stop();
 
         /* create BVH */
+        CommitPhaseTimer binningTimer(commitStats,RTC_BUILD_PHASE_BINNING,numPrimitivesGen);
         SetBVHNBounds<N> setBounds(bvh);
-        CreateMortonLeaf<N,Primitive> createLeaf(mesh,geomID_,morton.data());
-        CalculateMeshBounds<Mesh> calculateBounds(mesh);
+        CreateMortonLeaf<N,Primitive,BuildPrim> createLeaf(mesh,geomID_,morton.data());
+        CalculateMeshBounds<Mesh,BuildPrim> calculateBounds(mesh);
         auto root = BVHBuilderMorton::build<NodeRecord>(
           typename BVH::CreateAlloc(bvh), 
           typename BVH::AABBNode::Create(),
           setBounds,createLeaf,calculateBounds,bvh->scene->progressInterface,
           morton.data(),dest,numPrimitivesGen,settings);
+        binningTimer.stop();
         
         bvh->set(root.ref,LBBox3fa(root.bounds),numPrimitives);
         
@@ -529,12 +549,14 @@ namespace embree
       
       void clear() {
         morton.clear();
+        morton64.clear();
       }
       
     private:
       BVH* bvh;
       Mesh* mesh;
       mvector<BVHBuilderMorton::BuildPrim> morton;
+      mvector<BVHBuilderMorton::BuildPrim64> morton64;
       BVHBuilderMorton::Settings settings;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
       unsigned int numPreviousPrimitives = 0;
@@ -98,6 +98,7 @@ namespace embree
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max ();
       bool primrefarrayalloc;
       unsigned int numPreviousPrimitives = 0;
+      std::vector<float> geomWeights;
 
       BVHNBuilderSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize,
                       const Geometry::GTypeMask gtype, bool primrefarrayalloc = false)
@@ -109,6 +110,31 @@ namespace embree
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
+      /*! computes the relative intersection cost of each geometry, returns nullptr if all geometries have the same cost */
+      const float* computeGeometryWeights()
+      {
+        geomWeights.resize(scene->size());
+        float weight0 = 0.0f;
+        bool uniform = true;
+        for (size_t i=0; i<scene->size(); i++)
+        {
+          const Geometry* geom = scene->get(i);
+          if (geom == nullptr || !(geom->getTypeMask() & gtype_)) {
+            geomWeights[i] = 1.0f;
+            continue;
+          }
+          const float weight = geom->relativeIntersectionCost();
+          if (weight0 == 0.0f) weight0 = weight;
+          uniform &= weight == weight0;
+          geomWeights[i] = weight;
+        }
+        if (uniform) {
+          geomWeights.clear();
+          return nullptr;
+        }
+        return geomWeights.data();
+      }
+
       void build()
       {
         /* we reset the allocator when the mesh size changed */
@@ -153,9 +179,14 @@ namespace embree
             settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
             prims.resize(numPrimitives);
 
+            settings.commitStats = bvh->scene->getCommitStatistics();
+            bvh->alloc.setCommitStatistics(settings.commitStats);
+
+            CommitPhaseTimer primrefTimer(settings.commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numPrimitives);
             PrimInfo pinfo = mesh ?
               createPrimRefArray(mesh,geomID_,numPrimitives,prims,bvh->scene->progressInterface) :
               createPrimRefArray(scene,gtype_,false,numPrimitives,prims,bvh->scene->progressInterface);
+            primrefTimer.stop();
 
             /* pinfo might has zero size due to invalid geometry */
             if (unlikely(pinfo.size() == 0))
@@ -165,6 +196,12 @@ namespace embree
               return;
             }
 
+            /* guide the build by the sampled ray distribution of the scene */
+            settings.rayDistribution = scene && !scene->rayDistribution.empty() ? &scene->rayDistribution : nullptr;
+
+            /* isolate geometries that are expensive to intersect */
+            settings.geomWeights = scene ? computeGeometryWeights() : nullptr;
+
             /* call BVH builder */
             NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
@@ -242,9 +279,13 @@ namespace embree
 #endif
             /* create primref array */
             prims.resize(numPrimitives);
+            settings.commitStats = bvh->scene->getCommitStatistics();
+            bvh->alloc.setCommitStatistics(settings.commitStats);
+            CommitPhaseTimer primrefTimer(settings.commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numPrimitives);
             PrimInfo pinfo = mesh ?
               createPrimRefArray(mesh,geomID_,numPrimitives,prims,bvh->scene->progressInterface) :
 	      createPrimRefArray(scene,gtype_,false,numPrimitives,prims,bvh->scene->progressInterface);
+            primrefTimer.stop();
 
             /* enable os_malloc for two level build */
             if (mesh)
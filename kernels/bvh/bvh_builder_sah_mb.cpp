@@ -70,10 +70,11 @@ namespace embree
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecordMB4D NodeRecordMB4D;
 
-      __forceinline CreateMSMBlurLeaf (BVH* bvh) : bvh(bvh) {}
+      __forceinline CreateMSMBlurLeaf (BVH* bvh) : bvh(bvh), commitStats(bvh->scene->getCommitStatistics()) {}
 
       __forceinline const NodeRecordMB4D operator() (const BVHBuilderMSMBlur::BuildRecord& current, const FastAllocator::CachedAllocator& alloc) const
       {
+        CommitPhaseTimer timer(commitStats,RTC_BUILD_PHASE_LEAF_CREATION,current.prims.size());
         size_t items = Primitive::blocks(current.prims.size());
         size_t start = current.prims.begin();
         size_t end   = current.prims.end();
@@ -87,6 +88,7 @@ namespace embree
       }
 
       BVH* bvh;
+      CommitStatistics* commitStats;
     };
 
     /* Motion blur BVH with 4D nodes and internal time splits */
@@ -174,9 +176,14 @@ namespace embree
 
       void buildMultiSegment(size_t numPrimitives)
       {
+        CommitStatistics* commitStats = scene->getCommitStatistics();
+        bvh->alloc.setCommitStatistics(commitStats);
+
         /* create primref array */
         mvector<PrimRefMB> prims(scene->device,numPrimitives);
+        CommitPhaseTimer primrefTimer(commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numPrimitives);
 	PrimInfoMB pinfo = createPrimRefArrayMSMBlur(scene,gtype_,numPrimitives,prims,bvh->scene->progressInterface);
+        primrefTimer.stop();
 
         /* early out if no valid primitives */
         if (pinfo.size() == 0) { bvh->clear(); return; }
@@ -199,6 +206,7 @@ namespace embree
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
         
         /* build hierarchy */
+        CommitPhaseTimer binningTimer(commitStats,RTC_BUILD_PHASE_BINNING,pinfo.size());
         auto root =
           BVHBuilderMSMBlur::build<NodeRef>(prims,pinfo,scene->device,
                                             RecalculatePrimRef<Mesh>(scene),
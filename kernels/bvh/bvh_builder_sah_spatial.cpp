@@ -3,6 +3,7 @@
 
 #include "bvh.h"
 #include "bvh_builder.h"
+#include "bvh_restructure.h"
 
 #include "../builders/primrefgen.h"
 #include "../builders/primrefgen_presplit.h"
@@ -60,16 +61,23 @@ namespace embree
       mvector<PrimRef> prims0;
       GeneralBVHBuilder::Settings settings;
       const float splitFactor;
+      PresplitSettings presplitSettings;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
       unsigned int numPreviousPrimitives = 0;
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(scene), mesh(nullptr), prims0(scene->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications) {}
+          splitFactor(scene->device->max_spatial_split_replications), presplitSettings(getPresplitSettings(scene->device)) {}
 
       BVHNBuilderFastSpatialSAH (BVH* bvh, Mesh* mesh, const unsigned int geomID, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
         : bvh(bvh), scene(nullptr), mesh(mesh), prims0(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
-          splitFactor(scene->device->max_spatial_split_replications), geomID_(geomID) {}
+          splitFactor(bvh->device->max_spatial_split_replications), presplitSettings(getPresplitSettings(bvh->device)), geomID_(geomID) {}
+
+      static PresplitSettings getPresplitSettings(Device* device)
+      {
+        const PresplitSettings::Priority priority = device->presplit_priority == 1 ? PresplitSettings::PRIORITY_VOLUME : PresplitSettings::PRIORITY_AREA;
+        return PresplitSettings(priority,device->presplit_split_pos_weight,(unsigned int)device->presplit_max_splits_log);
+      }
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
@@ -100,6 +108,9 @@ namespace embree
         /* enable os_malloc for two level build */
         if (mesh)
           bvh->alloc.setOSallocation(true);
+
+        settings.commitStats = bvh->scene->getCommitStatistics();
+        bvh->alloc.setCommitStatistics(settings.commitStats);
 	
 	NodeRef root(0);
 	PrimInfo pinfo;
@@ -108,9 +119,18 @@ namespace embree
         if (likely(usePreSplits))
 	  {		     
             /* spatial presplit SAH BVH builder */
-	    pinfo = mesh ?
-	      createPrimRefArray_presplit<Mesh,Splitter>(mesh,maxGeomID,numOriginalPrimitives,prims0,bvh->scene->progressInterface) :
-	      createPrimRefArray_presplit<Mesh,Splitter>(scene,Mesh::geom_type,false,numOriginalPrimitives,prims0,bvh->scene->progressInterface);
+            PresplitStatistics presplitStats;
+            if (mesh) {
+              CommitPhaseTimer primrefTimer(settings.commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numOriginalPrimitives);
+              pinfo = createPrimRefArray_presplit<Mesh,Splitter>(mesh,maxGeomID,numOriginalPrimitives,prims0,bvh->scene->progressInterface);
+            }
+            else
+              pinfo = createPrimRefArray_presplit<Mesh,Splitter>(scene,Mesh::geom_type,false,numOriginalPrimitives,prims0,bvh->scene->progressInterface,presplitSettings,&presplitStats,settings.commitStats);
+
+            if (!mesh && bvh->device->verbosity(2)) {
+              Lock<MutexSys> lock(g_printMutex);
+              std::cout << presplitStats << std::endl;
+            }
 
 	    const size_t node_bytes = pinfo.size()*sizeof(typename BVH::AABBNode)/(4*N);
 	    const size_t leaf_bytes = size_t(1.2*Primitive::blocks(pinfo.size())*sizeof(Primitive));
@@ -126,9 +146,11 @@ namespace embree
 	else
 	  {
             /* standard spatial split SAH BVH builder */
+            CommitPhaseTimer primrefTimer(settings.commitStats,RTC_BUILD_PHASE_PRIMREF_GENERATION,numOriginalPrimitives);
 	    pinfo = mesh ?
 	      createPrimRefArray(mesh,geomID_,numSplitPrimitives,prims0,bvh->scene->progressInterface) :
 	      createPrimRefArray(scene,Mesh::geom_type,false,numSplitPrimitives,prims0,bvh->scene->progressInterface);
+            primrefTimer.stop();
 	
 	    Splitter splitter(scene);
 
@@ -141,6 +163,7 @@ namespace embree
 	    settings.maxDepth = BVH::maxBuildDepthLeaf;
 
 	    /* call BVH builder */
+            CommitPhaseTimer binningTimer(settings.commitStats,RTC_BUILD_PHASE_BINNING,pinfo.size());
 	    root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
 								  typename BVH::CreateAlloc(bvh),
 								  typename BVH::AABBNode::Create2(),
@@ -155,6 +178,25 @@ namespace embree
 	    /* ==================== */
 	  }
 
+        /* optimize BVH topology through treelet restructuring */
+        if (bvh->device->treelet_restructure_iterations > 0)
+        {
+          typename BVHNRestructure<N>::Statistics stats;
+          for (int i=0; i<bvh->device->treelet_restructure_iterations; i++)
+          {
+            const typename BVHNRestructure<N>::Statistics pass = BVHNRestructure<N>::restructure(bvh,root,pinfo.geomBounds);
+            if (i == 0) stats.nodeSAH0 = pass.nodeSAH0;
+            stats.nodeSAH1 = pass.nodeSAH1;
+            stats.numTreelets += pass.numTreelets;
+            stats.numRestructured += pass.numRestructured;
+            if (pass.numRestructured == 0) break;
+          }
+          if (bvh->device->verbosity(2)) {
+            Lock<MutexSys> lock(g_printMutex);
+            std::cout << stats << std::endl;
+          }
+        }
+
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
 
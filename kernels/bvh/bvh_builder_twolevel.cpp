@@ -111,6 +111,8 @@ namespace embree
 #if PROFILE
       double d0 = getSeconds();
 #endif
+      CommitPhaseTimer topLevelTimer(scene->getCommitStatistics(),RTC_BUILD_PHASE_TOP_LEVEL_BUILD,nextRef);
+
       /* fast path for single geometry scenes */
       if (nextRef == 1) { 
         bvh->set(refs[0].node,LBBox3fa(refs[0].bounds()),numPrimitives);
@@ -212,6 +214,7 @@ namespace embree
           }
         }
       }  
+      topLevelTimer.stop();
         
       bvh->alloc.cleanup();
       bvh->postBuild(t0);
@@ -28,6 +28,111 @@ namespace embree
 {
   namespace isa
   {
+    /*! primitives that represent a collapsed subtree by the first
+     *  primitive they store, which is possible for all primitive types
+     *  that store geometry and primitive IDs per item */
+    template<typename Primitive, typename = void>
+    struct ConeRepresentative
+    {
+      static const bool supported = false;
+      static __forceinline void get(const Primitive* prim, unsigned int& geomID, unsigned int& primID) {}
+    };
+
+    template<typename Primitive>
+    struct ConeRepresentative<Primitive, typename std::enable_if<
+      std::is_convertible<decltype(std::declval<const Primitive&>().geomID(size_t(0))),unsigned int>::value &&
+      std::is_convertible<decltype(std::declval<const Primitive&>().primID(size_t(0))),unsigned int>::value>::type>
+    {
+      static const bool supported = true;
+      static __forceinline void get(const Primitive* prim, unsigned int& geomID, unsigned int& primID) {
+        geomID = prim->geomID(0); primID = prim->primID(0);
+      }
+    };
+
+    template<>
+    struct ConeRepresentative<Object>
+    {
+      static const bool supported = true;
+      static __forceinline void get(const Object* prim, unsigned int& geomID, unsigned int& primID) {
+        geomID = prim->geomID(); primID = prim->primID();
+      }
+    };
+
+    /*! aggregate hit of a collapsed subtree, which is reported at the
+     *  entry distance of the subtree facing the ray */
+    struct ConeHit
+    {
+      __forceinline ConeHit(float t, const Vec3fa& Ng)
+        : u(0.0f), v(0.0f), t(t), Ng(Ng) {}
+
+      __forceinline void finalize() {}
+
+    public:
+      float u;
+      float v;
+      float t;
+      Vec3fa Ng;
+    };
+
+    /*! counts the primitives of a leaf for the traversal statistics,
+     *  primitive types without geometry IDs per item are counted per
+     *  block without geometry */
+    template<typename Primitive, typename = void>
+    struct LeafSample
+    {
+      static __forceinline void add(TraversalSample* sample, const RTCRayQueryContext* user, const Primitive* prim, size_t num)
+      {
+        sample->leaf(user,RTC_INVALID_GEOMETRY_ID);
+        for (size_t i=0; i<num; i++)
+          sample->primitive(user,RTC_INVALID_GEOMETRY_ID);
+      }
+    };
+
+    template<typename Primitive>
+    struct LeafSample<Primitive, typename std::enable_if<
+      std::is_convertible<decltype(std::declval<const Primitive&>().geomID(size_t(0))),unsigned int>::value &&
+      std::is_convertible<decltype(std::declval<const Primitive&>().size()),size_t>::value>::type>
+    {
+      static __forceinline void add(TraversalSample* sample, const RTCRayQueryContext* user, const Primitive* prim, size_t num)
+      {
+        sample->leaf(user,num ? prim[0].geomID(0) : RTC_INVALID_GEOMETRY_ID);
+        for (size_t i=0; i<num; i++)
+          for (size_t j=0; j<prim[i].size(); j++)
+            sample->primitive(user,prim[i].geomID(j));
+      }
+    };
+
+    template<typename Primitive>
+    struct LeafSample<Primitive, typename std::enable_if<
+      std::is_same<Primitive,Object>::value ||
+      std::is_same<Primitive,InstancePrimitive>::value ||
+      std::is_same<Primitive,InstanceArrayPrimitive>::value>::type>
+    {
+      static __forceinline unsigned int geomID(const Object& prim) { return prim.geomID(); }
+      static __forceinline unsigned int geomID(const InstancePrimitive& prim) { return prim.instID_; }
+      static __forceinline unsigned int geomID(const InstanceArrayPrimitive& prim) { return prim.instID_; }
+
+      static __forceinline void add(TraversalSample* sample, const RTCRayQueryContext* user, const Primitive* prim, size_t num)
+      {
+        sample->leaf(user,num ? geomID(prim[0]) : RTC_INVALID_GEOMETRY_ID);
+        for (size_t i=0; i<num; i++)
+          sample->primitive(user,geomID(prim[i]));
+      }
+    };
+
+    /*! finds the representative primitive of a subtree in its leftmost leaf */
+    template<typename BVH, typename Primitive>
+    __forceinline bool coneRepresentative(typename BVH::NodeRef cur, unsigned int& geomID, unsigned int& primID)
+    {
+      while (cur.isAABBNode())
+        cur = cur.getAABBNode()->child(0);
+      if (!cur.isLeaf() || cur == BVH::emptyNode) return false;
+      size_t num; const Primitive* prim = (const Primitive*)cur.leaf(num);
+      if (num == 0) return false;
+      ConeRepresentative<Primitive>::get(prim,geomID,primID);
+      return true;
+    }
+
     template<int N, int types, bool robust, typename PrimitiveIntersector1>
     void BVHNIntersector1<N, types, robust, PrimitiveIntersector1>::intersect(const Accel::Intersectors* __restrict__ This,
                                                                               RayHit& __restrict__ ray,
@@ -67,6 +172,10 @@ namespace embree
       /* initialize the node traverser */
       BVHNNodeTraverser1Hit<N, types> nodeTraverser;
 
+      /* initialize the ray cone, nodes get only collapsed in static BVHs with supported primitives */
+      static const bool coneCollapse = types == BVH_AN1 && ConeRepresentative<Primitive>::supported;
+      const TravRayCone cone(context->getRayConeWidth(), context->getRayConeSpread());
+
       /* pop loop */
       while (true) pop:
       {
@@ -87,6 +196,25 @@ namespace embree
           STAT3(normal.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
           if (unlikely(!nodeIntersected)) { STAT3(normal.trav_nodes,-1,-1,-1); break; }
+          if (unlikely(context->sample)) context->sample->node(context->user);
+
+          /* report children below the ray footprint as hits of their representative primitive */
+          if (coneCollapse && unlikely(cone.enabled()))
+          {
+            size_t collapsed = cone.collapse<N>(cur.getAABBNode(), tNear, mask);
+            while (collapsed)
+            {
+              const size_t i = bscf(collapsed);
+              unsigned int geomID, primID;
+              if (!coneRepresentative<BVH,Primitive>(cur.getAABBNode()->child(i),geomID,primID)) continue;
+              mask = btr(mask,i);
+              STAT3(normal.trav_leaves,1,1,1);
+              if (unlikely(context->sample)) context->sample->leaf(context->user,geomID);
+              ConeHit hit(tNear[i],-Vec3fa(ray.dir));
+              Intersect1Epilog1<true>(ray,context,geomID,primID)(hit);
+            }
+            tray.tfar = ray.tfar;
+          }
 
           /* if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -100,6 +228,7 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(normal.trav_leaves,1,1,1);
         size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+        if (unlikely(context->sample)) LeafSample<Primitive>::add(context->sample,context->user,prim,num);
         size_t lazy_node = 0;
         PrimitiveIntersector1::intersect(This, pre, ray, context, prim, num, tray, lazy_node);
         tray.tfar = ray.tfar;
@@ -153,6 +282,10 @@ namespace embree
       /* initialize the node traverser */
       BVHNNodeTraverser1Hit<N, types> nodeTraverser;
 
+      /* initialize the ray cone, nodes get only collapsed in static BVHs with supported primitives */
+      static const bool coneCollapse = types == BVH_AN1 && ConeRepresentative<Primitive>::supported;
+      const TravRayCone cone(context->getRayConeWidth(), context->getRayConeSpread());
+
       /* pop loop */
       while (true) pop:
       {
@@ -169,6 +302,27 @@ namespace embree
           STAT3(shadow.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
           if (unlikely(!nodeIntersected)) { STAT3(shadow.trav_nodes,-1,-1,-1); break; }
+          if (unlikely(context->sample)) context->sample->node(context->user);
+
+          /* children below the ray footprint occlude if their representative primitive does */
+          if (coneCollapse && unlikely(cone.enabled()))
+          {
+            size_t collapsed = cone.collapse<N>(cur.getAABBNode(), tNear, mask);
+            while (collapsed)
+            {
+              const size_t i = bscf(collapsed);
+              unsigned int geomID, primID;
+              if (!coneRepresentative<BVH,Primitive>(cur.getAABBNode()->child(i),geomID,primID)) continue;
+              mask = btr(mask,i);
+              STAT3(shadow.trav_leaves,1,1,1);
+              if (unlikely(context->sample)) context->sample->leaf(context->user,geomID);
+              ConeHit hit(tNear[i],-Vec3fa(ray.dir));
+              if (Occluded1Epilog1<true>(ray,context,geomID,primID)(hit)) {
+                ray.tfar = neg_inf;
+                return;
+              }
+            }
+          }
 
           /* if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -182,6 +336,7 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(shadow.trav_leaves,1,1,1);
         size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+        if (unlikely(context->sample)) LeafSample<Primitive>::add(context->sample,context->user,prim,num);
         size_t lazy_node = 0;
         if (PrimitiveIntersector1::occluded(This, pre, ray, context, prim, num, tray, lazy_node)) {
           ray.tfar = neg_inf;
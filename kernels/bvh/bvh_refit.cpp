@@ -187,8 +187,10 @@ namespace embree
         topologyVersion = mesh->getTopologyVersion();
         builder->build();
       }
-      else
+      else {
+        CommitPhaseTimer refitTimer(bvh->scene->getCommitStatistics(),RTC_BUILD_PHASE_REFIT,mesh->size());
         refitter->refit();
+      }
     }
 
     template class BVHNRefitter<4>;
@@ -0,0 +1,299 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh_restructure.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    template<int N>
+    class TreeletRestructurer
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AABBNode AABBNode;
+      typedef typename BVH::NodeRef NodeRef;
+      typedef typename BVHNRestructure<N>::Statistics Statistics;
+
+      static const size_t MAX_LEAVES = BVHNRestructure<N>::MAX_TREELET_LEAVES;
+      static const size_t MAX_SUBSETS = size_t(1) << MAX_LEAVES;
+
+      /*! subtrees up to this depth are processed in parallel */
+      static const size_t PARALLEL_DEPTH = 4;
+
+      /*! we only restructure a treelet if this reduces its cost by some margin */
+      static constexpr float MIN_IMPROVEMENT = 0.999f;
+
+      struct Result
+      {
+        Result () : height(0) {}
+
+        size_t height;     //!< number of inner node levels of the subtree
+        Statistics stats;
+      };
+
+      /*! treelet formed by the root node and some expanded inner nodes */
+      struct Treelet
+      {
+        ALIGNED_STRUCT_(16);
+
+        size_t numLeaves;
+        NodeRef leaves[MAX_LEAVES];
+        size_t numInner;
+        AABBNode* inner[MAX_LEAVES];                    //!< expanded inner nodes excluding the root
+
+        BBox3fa bounds[MAX_SUBSETS];                    //!< bounds of each subset of leaves
+        float opt[MAX_SUBSETS];                         //!< optimal cost of a subtree over each subset
+        float cost[N+1][MAX_SUBSETS];                   //!< optimal cost of partitioning each subset into up to k subtrees
+        unsigned short split[N+1][MAX_SUBSETS];         //!< first subtree of the partition, 0 if the subset forms a single subtree
+        unsigned short nodeSplit[MAX_SUBSETS];          //!< first child of the node over each subset
+      };
+
+    public:
+
+      TreeletRestructurer (BVH* bvh, double rcpRootArea)
+        : bvh(bvh), rcpRootArea(rcpRootArea) {}
+
+      static size_t height(NodeRef ref)
+      {
+        if (ref.isBarrier() || !ref.isAABBNode()) return 0;
+        AABBNode* node = ref.getAABBNode();
+        size_t h = 0;
+        for (size_t i=0; i<N; i++) h = max(h,height(node->child(i)));
+        return h+1;
+      }
+
+      Result recurse(NodeRef ref, const BBox3fa& bounds, size_t depth)
+      {
+        Result result;
+        if (ref.isBarrier() || !ref.isAABBNode()) return result;
+        AABBNode* node = ref.getAABBNode();
+
+        /* optimize all subtrees first */
+        Result cresults[N];
+        auto processChild = [&] (size_t i) {
+          cresults[i] = recurse(node->child(i),node->bounds(i),depth+1);
+        };
+        if (depth < PARALLEL_DEPTH) parallel_for(size_t(N),processChild);
+        else for (size_t i=0; i<N; i++) processChild(i);
+
+        size_t h = 0;
+        for (size_t i=0; i<N; i++) {
+          result.stats += cresults[i].stats;
+          h = max(h,cresults[i].height);
+        }
+        result.height = h+1;
+
+        const double area = double(halfArea(bounds))*rcpRootArea;
+        result.stats.nodeSAH0 += area;
+        result.stats.nodeSAH1 += area;
+        result.stats.numTreelets++;
+
+        optimize(node,depth,result);
+        return result;
+      }
+
+    private:
+
+      static size_t numChildren(const AABBNode* node)
+      {
+        size_t n = 0;
+        for (size_t i=0; i<N; i++) n += node->child(i) != BVH::emptyNode;
+        return n;
+      }
+
+      /*! forms the treelet by repeatedly expanding the treelet leaf with largest surface area */
+      static float formTreelet(AABBNode* root, Treelet& treelet)
+      {
+        BBox3fa* leafBounds = treelet.bounds;
+        treelet.numLeaves = treelet.numInner = 0;
+        for (size_t i=0; i<N; i++) {
+          if (root->child(i) == BVH::emptyNode) continue;
+          leafBounds[treelet.numLeaves] = root->bounds(i);
+          treelet.leaves[treelet.numLeaves++] = root->child(i);
+        }
+
+        float cost = 0.0f;
+        while (treelet.numInner < MAX_LEAVES)
+        {
+          ssize_t best = -1;
+          float bestArea = neg_inf;
+          for (size_t i=0; i<treelet.numLeaves; i++)
+          {
+            const NodeRef ref = treelet.leaves[i];
+            if (ref.isBarrier() || !ref.isAABBNode()) continue;
+            if (treelet.numLeaves-1+numChildren(ref.getAABBNode()) > MAX_LEAVES) continue;
+            const float area = halfArea(leafBounds[i]);
+            if (area > bestArea) { best = i; bestArea = area; }
+          }
+          if (best == -1) break;
+
+          AABBNode* node = treelet.leaves[best].getAABBNode();
+          treelet.inner[treelet.numInner++] = node;
+          cost += bestArea;
+
+          treelet.numLeaves--;
+          treelet.leaves[best] = treelet.leaves[treelet.numLeaves];
+          leafBounds[best] = leafBounds[treelet.numLeaves];
+          for (size_t i=0; i<N; i++) {
+            if (node->child(i) == BVH::emptyNode) continue;
+            leafBounds[treelet.numLeaves] = node->bounds(i);
+            treelet.leaves[treelet.numLeaves++] = node->child(i);
+          }
+        }
+        return cost;
+      }
+
+      /*! computes the optimal topology for all subsets of treelet
+       *  leaves in order of increasing subset index, thus all proper
+       *  subsets got processed before */
+      static void optimalTopology(Treelet& treelet)
+      {
+        BBox3fa leafBounds[MAX_LEAVES];
+        for (size_t i=0; i<treelet.numLeaves; i++)
+          leafBounds[i] = treelet.bounds[i];
+
+        const unsigned numSubsets = 1 << treelet.numLeaves;
+        for (unsigned S=1; S<numSubsets; S++)
+        {
+          const unsigned low = S & (0-S);
+          if (S == low)
+          {
+            treelet.bounds[S] = leafBounds[bsf(S)];
+            treelet.opt[S] = 0.0f;
+            for (size_t k=1; k<=N; k++) {
+              treelet.cost[k][S] = 0.0f;
+              treelet.split[k][S] = 0;
+            }
+            continue;
+          }
+          treelet.bounds[S] = merge(treelet.bounds[S^low],treelet.bounds[low]);
+
+          /* find best partition into 2 to k subtrees for all k, the
+           * first subtree always contains the lowest leaf to avoid
+           * enumerating permutations */
+          size_t count = 0;
+          for (unsigned s=S; s; s&=s-1) count++;
+          float bestCost[N+1];
+          unsigned bestSplit[N+1];
+          for (size_t k=2; k<=N; k++) {
+            bestCost[k] = count <= k ? 0.0f : float(inf);
+            bestSplit[k] = low;
+          }
+
+          const unsigned R = S^low;
+          if (count > 2)
+          {
+            for (unsigned sub = (R-1) & R;; sub = (sub-1) & R)
+            {
+              const unsigned T = low | sub;
+              for (size_t k=2; k<min(count,size_t(N+1)); k++) {
+                const float c = treelet.opt[T] + treelet.cost[k-1][S^T];
+                if (c < bestCost[k]) { bestCost[k] = c; bestSplit[k] = T; }
+              }
+              if (sub == 0) break;
+            }
+          }
+
+          const float opt = halfArea(treelet.bounds[S]) + bestCost[N];
+          treelet.opt[S] = opt;
+          treelet.nodeSplit[S] = bestSplit[N];
+          treelet.cost[1][S] = opt;
+          treelet.split[1][S] = 0;
+          for (size_t k=2; k<=N; k++) {
+            const bool single = opt < bestCost[k];
+            treelet.cost[k][S] = single ? opt : bestCost[k];
+            treelet.split[k][S] = single ? 0 : bestSplit[k];
+          }
+        }
+      }
+
+      /*! returns the children of the node over leaf subset S */
+      static size_t children(const Treelet& treelet, unsigned S, unsigned* groups)
+      {
+        size_t n = 0;
+        groups[n++] = treelet.nodeSplit[S];
+        S ^= treelet.nodeSplit[S];
+        for (size_t k=N-1;; k--)
+        {
+          const unsigned T = treelet.split[k][S];
+          if (T == 0) { groups[n++] = S; break; }
+          groups[n++] = T;
+          S ^= T;
+        }
+        return n;
+      }
+
+      static size_t height(const Treelet& treelet, const size_t* leafHeights, unsigned S)
+      {
+        if (S == (S & (0-S))) return leafHeights[bsf(S)];
+        unsigned groups[N];
+        const size_t n = children(treelet,S,groups);
+        size_t h = 0;
+        for (size_t i=0; i<n; i++) h = max(h,height(treelet,leafHeights,groups[i]));
+        return h+1;
+      }
+
+      NodeRef create(Treelet& treelet, const FastAllocator::CachedAllocator& alloc, AABBNode* node, unsigned S)
+      {
+        if (S == (S & (0-S))) return treelet.leaves[bsf(S)];
+
+        if (node == nullptr) {
+          if (treelet.numInner) node = treelet.inner[--treelet.numInner];
+          else node = (AABBNode*) alloc.malloc0(sizeof(AABBNode),NodeRef::byteNodeAlignment);
+        }
+        node->clear();
+
+        unsigned groups[N];
+        const size_t n = children(treelet,S,groups);
+        for (size_t i=0; i<n; i++)
+          node->set(i,create(treelet,alloc,nullptr,groups[i]),treelet.bounds[groups[i]]);
+        return BVH::encodeNode(node);
+      }
+
+      __noinline void optimize(AABBNode* root, size_t depth, Result& result)
+      {
+        std::unique_ptr<Treelet> treelet(new Treelet);
+        const float oldCost = formTreelet(root,*treelet);
+        if (treelet->numInner == 0) return;
+
+        optimalTopology(*treelet);
+        const unsigned all = (1 << treelet->numLeaves)-1;
+        const float newCost = treelet->opt[all] - halfArea(treelet->bounds[all]);
+        if (!(newCost < MIN_IMPROVEMENT*oldCost)) return;
+
+        /* the new topology must not exceed the maximal BVH depth */
+        size_t leafHeights[MAX_LEAVES];
+        for (size_t i=0; i<treelet->numLeaves; i++)
+          leafHeights[i] = height(treelet->leaves[i]);
+        const size_t newHeight = height(*treelet,leafHeights,all);
+        if (depth+newHeight > BVH::maxBuildDepthLeaf) return;
+
+        create(*treelet,bvh->alloc.getCachedAllocator(),root,all);
+
+        result.height = newHeight;
+        result.stats.nodeSAH1 += double(newCost-oldCost)*rcpRootArea;
+        result.stats.numRestructured++;
+      }
+
+    private:
+      BVH* bvh;
+      const double rcpRootArea;
+    };
+
+    template<int N>
+    typename BVHNRestructure<N>::Statistics BVHNRestructure<N>::restructure(BVH* bvh, NodeRef root, const BBox3fa& bounds)
+    {
+      const float rootArea = halfArea(bounds);
+      const double rcpRootArea = rootArea > 0.0f ? 1.0/double(rootArea) : 0.0;
+      TreeletRestructurer<N> restructurer(bvh,rcpRootArea);
+      return restructurer.recurse(root,bounds,0).stats;
+    }
+
+    template class BVHNRestructure<4>;
+#if defined(__AVX__)
+    template class BVHNRestructure<8>;
+#endif
+  }
+}
@@ -0,0 +1,66 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Treelet restructuring optimizer. Post-build pass that forms a
+     *  small treelet at each node of an AABB BVH, finds the topology
+     *  with minimal SAH for the leaves of that treelet through dynamic
+     *  programming over all subsets of leaves, and rewrites the treelet
+     *  if this reduces the SAH. The BVH is processed bottom up, such
+     *  that optimizations of lower treelets propagate upwards. */
+    template<int N>
+    class BVHNRestructure
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AABBNode AABBNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+    public:
+
+      /*! maximal number of leaves per treelet */
+      static const size_t MAX_TREELET_LEAVES = 2*N < 10 ? 2*N : 10;
+
+      /*! statistics of a restructuring pass */
+      struct Statistics
+      {
+        Statistics ()
+          : numTreelets(0), numRestructured(0), nodeSAH0(0.0), nodeSAH1(0.0) {}
+
+        __forceinline Statistics& operator+= (const Statistics& other)
+        {
+          numTreelets += other.numTreelets;
+          numRestructured += other.numRestructured;
+          nodeSAH0 += other.nodeSAH0;
+          nodeSAH1 += other.nodeSAH1;
+          return *this;
+        }
+
+        friend embree_ostream operator<<(embree_ostream cout, const Statistics& stats)
+        {
+          const double improvement = stats.nodeSAH0 > 0.0 ? 100.0*(1.0-stats.nodeSAH1/stats.nodeSAH0) : 0.0;
+          return cout << "Treelet restructuring: "
+                      << "#treelets = " << stats.numTreelets << ", "
+                      << "#restructured = " << stats.numRestructured << ", "
+                      << "nodeSAH = " << stats.nodeSAH0 << " -> " << stats.nodeSAH1 << " (" << improvement << "% improvement)";
+        }
+
+      public:
+        size_t numTreelets;     //!< number of treelets considered
+        size_t numRestructured; //!< number of treelets that got restructured
+        double nodeSAH0;        //!< node SAH of the BVH before the pass
+        double nodeSAH1;        //!< node SAH of the BVH after the pass
+      };
+
+      /*! restructures the BVH with root node 'root' and bounds 'bounds',
+       *  new nodes get allocated from the BVH allocator */
+      static Statistics restructure(BVH* bvh, NodeRef root, const BBox3fa& bounds);
+    };
+  }
+}
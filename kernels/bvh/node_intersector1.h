@@ -1487,6 +1487,38 @@ namespace embree
 
     };
 
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Ray cone used to collapse nodes below the ray footprint
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    /*! The footprint of a ray cone grows linearly with the ray
+     *  distance. Nodes whose bounding box diagonal is not larger than
+     *  the footprint at the node entry distance get collapsed. */
+    struct TravRayCone
+    {
+      __forceinline TravRayCone(float width, float spread)
+        : width(width), spread(spread) {}
+
+      __forceinline bool enabled() const {
+        return width > 0.0f || spread > 0.0f;
+      }
+
+      /*! returns the subset of the hit children that are below the footprint */
+      template<int N>
+      __forceinline size_t collapse(const typename BVHN<N>::AABBNode* node, const vfloat<N>& tNear, size_t mask) const
+      {
+        const vfloat<N> dx = node->upper_x-node->lower_x;
+        const vfloat<N> dy = node->upper_y-node->lower_y;
+        const vfloat<N> dz = node->upper_z-node->lower_z;
+        const vfloat<N> footprint = madd(vfloat<N>(spread),tNear,vfloat<N>(width));
+        const vbool<N> vmask = madd(dx,dx,madd(dy,dy,dz*dz)) <= footprint*footprint;
+        return movemask(vmask) & mask;
+      }
+
+    public:
+      float width;   //!< footprint width at the ray origin
+      float spread;  //!< footprint width increase per unit of ray distance
+    };
 
   }
 }
@@ -186,6 +186,7 @@ namespace embree
       , bytesUsed(0)
       , bytesFree(0)
       , bytesWasted(0)
+      , commitStats(nullptr)
       , atype(osAllocation ? EMBREE_OS_MALLOC : ALIGNED_MALLOC)
       , primrefarray(device,0)
     {
@@ -229,6 +230,12 @@ namespace embree
       atype = flag ? EMBREE_OS_MALLOC : ALIGNED_MALLOC;
     }
 
+    /*! measures the time spent allocating new blocks when statistics are passed */
+    void setCommitStatistics(CommitStatistics* stats)
+    {
+      commitStats = stats;
+    }
+
   private:
 
     /*! returns both fast thread local allocators */
@@ -514,6 +521,7 @@ namespace embree
         /* parallel block creation in case of no freeBlocks, avoids single global mutex */
         if (likely(freeBlocks.load() == nullptr))
         {
+          CommitPhaseTimer timer(commitStats,RTC_BUILD_PHASE_ALLOCATOR_WAIT);
           Lock<MutexSys> lock(slotMutex[slot]);
           if (myUsedBlocks == threadUsedBlocks[slot]) {
             const size_t alignedBytes = (bytes+(align-1)) & ~(align-1);
@@ -527,6 +535,7 @@ namespace embree
 
         /* if this fails allocate new block */
         {
+          CommitPhaseTimer timer(commitStats,RTC_BUILD_PHASE_ALLOCATOR_WAIT);
           Lock<MutexSys> lock(mutex);
           if (myUsedBlocks == threadUsedBlocks[slot])
           {
@@ -992,6 +1001,7 @@ namespace embree
     std::atomic<size_t> bytesUsed;
     std::atomic<size_t> bytesFree;
     std::atomic<size_t> bytesWasted;
+    CommitStatistics* commitStats; //!< optional statistics of the running commit
 
     static __thread ThreadLocal2* thread_local_allocator2;
     static MutexSys s_thread_local_allocators_lock;
@@ -10,6 +10,8 @@
 namespace embree
 {
   class Scene;
+  struct MultiHitQuery;
+  struct TraversalSample;
 
   struct RayQueryContext
   {
@@ -55,10 +57,25 @@ namespace embree
     }
 #endif
 
+    __forceinline float getCurveLODDistanceFactor() const {
+      return args->curveLODDistanceFactor;
+    }
+
+    __forceinline float getRayConeWidth() const {
+      return args->rayConeWidth;
+    }
+
+    __forceinline float getRayConeSpread() const {
+      return args->rayConeSpread;
+    }
+
   public:
     Scene* scene = nullptr;
     RTCRayQueryContext* user = nullptr;
     RTCIntersectArguments* args = nullptr;
+    MultiHitQuery* multiHit = nullptr;   //!< collects the closest hits of a multi-hit query
+    RTCRayHit* anyHit = nullptr;         //!< receives the hit of an any-hit query
+    TraversalSample* sample = nullptr;   //!< counts the traversal steps of a sampled ray
   };
 
   template<int M, typename Geometry>
@@ -46,6 +46,7 @@ namespace embree
     : device(device), userPtr(nullptr),
       numPrimitives(numPrimitives), numTimeSteps(unsigned(numTimeSteps)), fnumTimeSegments(float(numTimeSteps-1)), time_range(0.0f,1.0f),
       mask(1),
+      intersectionCost(defaultIntersectionCost(gtype)),
       gtype(gtype),
       gsubtype(GTY_SUBTYPE_DEFAULT),
       quality(RTC_BUILD_QUALITY_MEDIUM),
@@ -94,6 +95,38 @@ namespace embree
     return time_range;
   }
 
+  float Geometry::defaultIntersectionCost(GType gtype)
+  {
+    switch (gtype)
+    {
+    case GTY_TRIANGLE_MESH:
+    case GTY_SPHERE_POINT:
+    case GTY_DISC_POINT:
+    case GTY_ORIENTED_DISC_POINT:
+      return 1.0f;
+
+    case GTY_QUAD_MESH:
+    case GTY_GRID_MESH:
+    case GTY_FLAT_LINEAR_CURVE:
+    case GTY_ROUND_LINEAR_CURVE:
+    case GTY_CONE_LINEAR_CURVE:
+    case GTY_ORIENTED_LINEAR_CURVE:
+      return 2.0f;
+
+    case GTY_SUBDIV_MESH:
+    case GTY_USER_GEOMETRY:
+      return 4.0f;
+
+    case GTY_INSTANCE_CHEAP:
+    case GTY_INSTANCE_EXPENSIVE:
+    case GTY_INSTANCE_ARRAY:
+      return 8.0f;
+
+    default: // higher order curves
+      return 4.0f;
+    }
+  }
+
   void Geometry::update()
   {
     ++modCounter_; // FIXME: required?
@@ -326,6 +326,21 @@ namespace embree
       Geometry::update();
     }
 
+    /*! sets the estimated cost to intersect a primitive of this geometry, in units of a triangle intersection */
+    void setIntersectionCost(float cost)
+    {
+      this->intersectionCost = cost;
+      Geometry::update();
+    }
+
+    /*! returns the intersection cost relative to the default intersection cost of the geometry type */
+    __forceinline float relativeIntersectionCost() const {
+      return intersectionCost/defaultIntersectionCost(gtype);
+    }
+
+    /*! returns the default intersection cost of primitives of some geometry type, in units of a triangle intersection */
+    static float defaultIntersectionCost(GType gtype);
+
     /* calculate time segment itime and fractional time ftime */
     __forceinline int timeSegment(float time, float& ftime) const {
       return getTimeSegment(time,time_range.lower,time_range.upper,fnumTimeSegments,ftime);
@@ -645,6 +660,7 @@ namespace embree
     BBox1f time_range;          //!< motion blur time range
     
     unsigned int mask;             //!< for masking out geometry
+    float intersectionCost;        //!< estimated cost to intersect a primitive, in units of a triangle intersection
     unsigned int modCounter_ = 1; //!< counter for every modification - used to rebuild scenes when geo is modified
 
     struct {
@@ -121,6 +121,45 @@ namespace embree
     return cout << "}";
   }
 
+  /*! Closest hits of a multi-hit query sorted by distance. */
+  struct MultiHitQuery
+  {
+    __forceinline MultiHitQuery (RTCMultiHit* hits, unsigned int maxHits)
+      : hits(hits), maxHits(maxHits), numHits(0) {}
+
+    /*! inserts a hit, returns false if the hit is not among the closest hits */
+    __forceinline bool insert(float t, const Hit& hit)
+    {
+      if (numHits == maxHits && !(t < hits[maxHits-1].t))
+        return false;
+
+      /* the same primitive may get referenced by multiple leaves */
+      for (unsigned int i=0; i<numHits; i++) {
+        const Hit& other = (const Hit&) hits[i].hit;
+        if (hits[i].t == t && other.primID == hit.primID && other.geomID == hit.geomID && other.instID[0] == hit.instID[0])
+          return false;
+      }
+
+      unsigned int i = min(numHits,maxHits-1);
+      for (; i>0 && t < hits[i-1].t; i--)
+        hits[i] = hits[i-1];
+      (Hit&) hits[i].hit = hit;
+      hits[i].t = t;
+      numHits = min(numHits+1,maxHits);
+      return true;
+    }
+
+    /*! once all hit slots are filled the traversal only has to find hits closer than the last one */
+    __forceinline float cullDistance(float tfar) const {
+      return numHits == maxHits ? min(tfar,hits[maxHits-1].t) : tfar;
+    }
+
+  public:
+    RTCMultiHit* hits;           //!< user provided hit array
+    const unsigned int maxHits;  //!< size of the hit array
+    unsigned int numHits;        //!< number of valid hits
+  };
+
   template<typename Hit>
     __forceinline void copyHitToRay(RayHit& ray, const Hit& hit)
   {
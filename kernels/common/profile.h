@@ -4,6 +4,7 @@
 #pragma once
 
 #include "default.h"
+#include "rtcore.h"
 
 namespace embree
 {
@@ -156,4 +157,114 @@ namespace embree
       }
       timer.print(numElements);
     }
+
+  /*! Per phase timings and counters of a scene commit. Gathering is
+   *  enabled at runtime with the commit_statistics device
+   *  configuration, otherwise the builders get a null pointer. */
+  struct CommitStatistics
+  {
+    CommitStatistics () {
+      reset();
+    }
+
+    void reset()
+    {
+      for (size_t i=0; i<RTC_BUILD_PHASE_COUNT; i++) {
+        count[i] = 0;
+        numPrimitives[i] = 0;
+        nanoseconds[i] = 0;
+      }
+    }
+
+    /*! adds one execution of a phase, safe to call from multiple threads */
+    __forceinline void add(RTCBuildPhase phase, double dt, size_t numPrims = 0)
+    {
+      count[phase]++;
+      numPrimitives[phase] += numPrims;
+      nanoseconds[phase] += uint64_t(max(dt,0.0)*1E9);
+    }
+
+    /*! returns the phase the given phase is nested in */
+    static RTCBuildPhase parent(RTCBuildPhase phase)
+    {
+      switch (phase) {
+      case RTC_BUILD_PHASE_LEAF_CREATION : return RTC_BUILD_PHASE_BINNING;
+      case RTC_BUILD_PHASE_ALLOCATOR_WAIT: return RTC_BUILD_PHASE_BINNING;
+      default                            : return RTC_BUILD_PHASE_COMMIT;
+      }
+    }
+
+    static const char* name(RTCBuildPhase phase)
+    {
+      switch (phase) {
+      case RTC_BUILD_PHASE_COMMIT            : return "commit";
+      case RTC_BUILD_PHASE_PRIMREF_GENERATION: return "primref generation";
+      case RTC_BUILD_PHASE_PRESPLIT          : return "presplit";
+      case RTC_BUILD_PHASE_BINNING           : return "binning";
+      case RTC_BUILD_PHASE_LEAF_CREATION     : return "leaf creation";
+      case RTC_BUILD_PHASE_ALLOCATOR_WAIT    : return "allocator wait";
+      case RTC_BUILD_PHASE_REFIT             : return "refit";
+      case RTC_BUILD_PHASE_TOP_LEVEL_BUILD   : return "top level build";
+      default                                : return "unknown";
+      }
+    }
+
+    void get(RTCSceneCommitStatistics& stats) const
+    {
+      for (size_t i=0; i<RTC_BUILD_PHASE_COUNT; i++)
+      {
+        stats.phases[i].parent = parent(RTCBuildPhase(i));
+        stats.phases[i].count = count[i];
+        stats.phases[i].numPrimitives = numPrimitives[i];
+        stats.phases[i].time = 1E-9*double(nanoseconds[i]);
+      }
+    }
+
+    void print() const
+    {
+      std::cout << "commit statistics:" << std::endl;
+      for (size_t i=0; i<RTC_BUILD_PHASE_COUNT; i++)
+      {
+        const RTCBuildPhase phase = RTCBuildPhase(i);
+        if (count[i] == 0) continue;
+        const size_t depth = phase == RTC_BUILD_PHASE_COMMIT ? 1 : parent(phase) == RTC_BUILD_PHASE_COMMIT ? 2 : 3;
+        std::cout << std::string(2*depth,' ') << name(phase) << ": " << 1E-6*double(nanoseconds[i]) << " ms, "
+                  << count[i] << " times, " << numPrimitives[i] << " primitives" << std::endl;
+      }
+    }
+
+  public:
+    std::atomic<size_t> count[RTC_BUILD_PHASE_COUNT];          //!< number of times each phase got executed
+    std::atomic<size_t> numPrimitives[RTC_BUILD_PHASE_COUNT];  //!< number of primitives processed by each phase
+    std::atomic<uint64_t> nanoseconds[RTC_BUILD_PHASE_COUNT];  //!< accumulated time of each phase
+  };
+
+  /*! measures the time of a build phase until the end of its scope, does nothing without statistics */
+  struct CommitPhaseTimer
+  {
+    __forceinline CommitPhaseTimer (CommitStatistics* stats, RTCBuildPhase phase, size_t numPrimitives = 0)
+      : stats(stats), phase(phase), numPrimitives(numPrimitives), t0(stats ? getSeconds() : 0.0) {}
+
+    __forceinline ~CommitPhaseTimer () {
+      stop();
+    }
+
+    /*! ends the phase before the end of the scope */
+    __forceinline void stop()
+    {
+      if (unlikely(stats)) stats->add(phase,getSeconds()-t0,numPrimitives);
+      stats = nullptr;
+    }
+
+    /*! sets the number of processed primitives when it is only known at the end of the phase */
+    __forceinline void setPrimitives(size_t n) {
+      numPrimitives = n;
+    }
+
+  private:
+    CommitStatistics* stats;
+    RTCBuildPhase phase;
+    size_t numPrimitives;
+    double t0;
+  };
 }
@@ -265,6 +265,49 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcGetSceneCommitStatistics (RTCScene hscene, RTCSceneCommitStatistics* stats)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetSceneCommitStatistics);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_VERIFY_HANDLE(stats);
+    RTC_ENTER_DEVICE(hscene);
+    if (!scene->device->commit_statistics)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"commit statistics not enabled, use the commit_statistics device configuration");
+    scene->commitStats.get(*stats);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcGetSceneTraversalStatistics (RTCScene hscene, unsigned int geomID, RTCTraversalStatistics* stats)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetSceneTraversalStatistics);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_VERIFY_HANDLE(stats);
+    RTC_ENTER_DEVICE(hscene);
+    if (!scene->getTraversalStatistics())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"traversal statistics not enabled, use the traversal_statistics device configuration");
+    if (geomID != RTC_INVALID_GEOMETRY_ID && geomID >= scene->size())
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid geometry ID");
+    scene->getTraversalStatistics()->get(geomID,*stats);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcResetSceneTraversalStatistics (RTCScene hscene)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcResetSceneTraversalStatistics);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_ENTER_DEVICE(hscene);
+    if (!scene->getTraversalStatistics())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"traversal statistics not enabled, use the traversal_statistics device configuration");
+    scene->getTraversalStatistics()->reset();
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcSetSceneBuildQuality (RTCScene hscene, RTCBuildQuality quality) 
   {
     Scene* scene = (Scene*) hscene;
@@ -280,6 +323,21 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcSetSceneRayDistributionHint (RTCScene hscene, const RTCRay* rays, size_t numRays, float weight)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetSceneRayDistributionHint);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_ENTER_DEVICE(hscene);
+    if (numRays && rays == nullptr)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid ray array");
+    if (!(weight >= 0.0f && weight <= 1.0f))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"weight has to be in [0,1] range");
+    scene->setRayDistribution(rays,numRays,weight);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcSetSceneFlags (RTCScene hscene, RTCSceneFlags flags) 
   {
     Scene* scene = (Scene*) hscene;
@@ -534,6 +592,28 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2_FALSE(scene);
   }
 
+  /*! traces a single ray and counts its traversal steps when it gets sampled for the statistics or its cost is requested */
+  template<typename Closure>
+  __forceinline void traceCounted(Scene* scene, RayQueryContext& context, const Closure& trace)
+  {
+    RTCRayCost* cost = context.args->cost;
+    TraversalStatistics* stats = scene->getTraversalStatistics();
+    if (stats && !stats->sample()) stats = nullptr;
+    if (likely(!stats && !cost)) {
+      trace();
+      return;
+    }
+    TraversalSample sample(stats,context.user);
+    context.sample = &sample;
+    trace();
+    if (stats) stats->add(sample);
+    if (cost) {
+      cost->nodes = (unsigned int) sample.nodes;
+      cost->leaves = (unsigned int) sample.leaves;
+      cost->primitives = (unsigned int) sample.primitives;
+    }
+  }
+
   RTC_API void rtcIntersect1 (RTCScene hscene, RTCRayHit* rayhit, RTCIntersectArguments* args) 
   {
     Scene* scene = (Scene*) hscene;
@@ -560,7 +640,83 @@ RTC_NAMESPACE_BEGIN;
     }
     RayQueryContext context(scene,user_context,args);
     
-    scene->intersectors.intersect(*rayhit,&context);
+    traceCounted(scene,context,[&] { scene->intersectors.intersect(*rayhit,&context); });
+#if defined(DEBUG)
+    ((RayHit*)rayhit)->verifyHit();
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API unsigned int rtcIntersectMulti (RTCScene hscene, RTCRay* ray, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectMulti);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)ray) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");
+    if (((size_t)hits) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "hits not aligned to 16 bytes");
+#endif
+    STAT3(normal.travs,1,1,1);
+    if (maxHits == 0) return 0;
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+
+    /* the epilogs record all hits into the hit array, the ray only gets culled against the last hit slot */
+    MultiHitQuery multiHit(hits,maxHits);
+    RayQueryContext context(scene,user_context,args);
+    context.multiHit = &multiHit;
+
+    RayHit rayhit(*(Ray*)ray);
+    traceCounted(scene,context,[&] { scene->intersectors.intersect((RTCRayHit&)rayhit,&context); });
+    return multiHit.numHits;
+    RTC_CATCH_END2(scene);
+    return 0;
+  }
+
+  RTC_API void rtcIntersectAny (RTCScene hscene, RTCRayHit* rayhit, RTCIntersectArguments* args)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectAny);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)rayhit) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");
+#endif
+    STAT3(shadow.travs,1,1,1);
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+
+    /* the occlusion traversal terminates at the first accepted hit, whose data the epilogs write into the ray/hit structure */
+    RayQueryContext context(scene,user_context,args);
+    context.anyHit = rayhit;
+
+    Ray ray(*(RayHit*)rayhit);
+    traceCounted(scene,context,[&] { scene->intersectors.occluded((RTCRay&)ray,&context); });
 #if defined(DEBUG)
     ((RayHit*)rayhit)->verifyHit();
 #endif
@@ -879,7 +1035,7 @@ RTC_NAMESPACE_BEGIN;
     }
     RayQueryContext context(scene,user_context,args);
     
-    scene->intersectors.occluded(*ray,&context);
+    traceCounted(scene,context,[&] { scene->intersectors.occluded(*ray,&context); });
     RTC_CATCH_END2(scene);
   }
 
@@ -1594,6 +1750,19 @@ RTC_API void rtcSetGeometryTransform(RTCGeometry hgeometry, unsigned int timeSte
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryIntersectionCost (RTCGeometry hgeometry, float cost)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryIntersectionCost);
+    RTC_VERIFY_HANDLE(hgeometry);
+    RTC_ENTER_DEVICE(hgeometry);
+    if (!(cost > 0.0f && cost < float(inf)))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"intersection cost has to be positive");
+    geometry->setIntersectionCost(cost);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcSetGeometryMaxRadiusScale(RTCGeometry hgeometry, float maxRadiusScale)
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -11,21 +11,36 @@
 
 #include "../builders/bvh_builder_sah.h"
 #include "../builders/bvh_builder_morton.h"
+#include "../builders/bvh_builder_msmblur.h"
+#include "../builders/primrefgen_presplit.h"
+
+#include <unordered_map>
 
 namespace embree
 { 
   namespace isa // FIXME: support more ISAs for builders
   {
+    struct FlatBVHUpdater;
+
     struct BVH : public RefCount
     {
       BVH (Device* device)
-        : device(device), allocator(device,true), morton_src(device,0), morton_tmp(device,0)
+        : device(device), allocator(device,true), morton_src(device,0), morton_tmp(device,0), morton64_src(device,0), morton64_tmp(device,0),
+          flat_nodes(device,0), flat_prims(device,0), numFlatNodes(0)
       {
         device->refInc();
       }
 
-      ~BVH() {
-        device->refDec();
+      ~BVH();
+
+      /* frees the temporary data of the builders */
+      void clearTemporaryData()
+      {
+        morton_src.clear();
+        morton_tmp.clear();
+        morton64_src.clear();
+        morton64_tmp.clear();
+        flat_prims.clear();
       }
 
     public:
@@ -33,17 +48,148 @@ namespace embree
       FastAllocator allocator;
       mvector<BVHBuilderMorton::BuildPrim> morton_src;
       mvector<BVHBuilderMorton::BuildPrim> morton_tmp;
+      mvector<BVHBuilderMorton::BuildPrim64> morton64_src;
+      mvector<BVHBuilderMorton::BuildPrim64> morton64_tmp;
+      mvector<RTCFlatBVHNode> flat_nodes;     //!< nodes of the last build with RTC_BUILD_FLAG_FLAT_NODES
+      mvector<RTCBuildPrimitive> flat_prims;  //!< primitives in leaf order for the morton builder
+      size_t numFlatNodes;                    //!< number of used nodes in flat_nodes
+      std::unique_ptr<FlatBVHUpdater> updater; //!< state for incremental updates of the flat nodes
     };
 
-    void* rtcBuildBVHMorton(const RTCBuildArguments* arguments)
+    /* passes the nodes and leaves to the callbacks of the application */
+    struct CallbackOutput
     {
+      typedef void* NodeRef;
+
+      CallbackOutput (const RTCBuildArguments* arguments)
+        : createNodeFunc(arguments->createNode), setNodeChildrenFunc(arguments->setNodeChildren),
+          setNodeBoundsFunc(arguments->setNodeBounds), createLeafFunc(arguments->createLeaf), userPtr(arguments->userPtr) {}
+
+      __forceinline NodeRef createNode(const FastAllocator::CachedAllocator& alloc, size_t N) const {
+        return createNodeFunc((RTCThreadLocalAllocator)&alloc,(unsigned int)N,userPtr);
+      }
+
+      __forceinline void setBounds(NodeRef node, const RTCBounds** bounds, size_t N) const {
+        setNodeBoundsFunc(node,bounds,(unsigned int)N,userPtr);
+      }
+
+      __forceinline void setChildren(NodeRef node, NodeRef* children, size_t N) const {
+        setNodeChildrenFunc(node,children,(unsigned int)N,userPtr);
+      }
+
+      /* creates a leaf for the primitives that start at index begin of the (reordered) primitive array */
+      __forceinline NodeRef createLeaf(const FastAllocator::CachedAllocator& alloc, const RTCBuildPrimitive* prims, size_t begin, size_t N) const {
+        return createLeafFunc((RTCThreadLocalAllocator)&alloc,prims,N,userPtr);
+      }
+
+      __forceinline void beginReorder(size_t N) {}
+      __forceinline void endReorder(RTCBuildPrimitive* prims, size_t N) {}
+
+      __forceinline void* finish(NodeRef root, const BBox3fa& bounds) const {
+        return root;
+      }
+
+      RTCCreateNodeFunction createNodeFunc;
+      RTCSetNodeChildrenFunction setNodeChildrenFunc;
+      RTCSetNodeBoundsFunction setNodeBoundsFunc;
+      RTCCreateLeafFunction createLeafFunc;
+      void* userPtr;
+    };
+
+    /* stores the BVH into an array of flat nodes without invoking any callbacks, the
+     * children of a node are stored consecutively and the root is stored at index 0 */
+    struct FlatOutput
+    {
+      struct NodeRef
+      {
+        __forceinline NodeRef () {}
+        __forceinline NodeRef (size_t offset, size_t count)
+          : offset((unsigned int)offset), count((unsigned int)count) {}
+
+        unsigned int offset; //!< index of first child node or first primitive
+        unsigned int count;  //!< number of children or number of primitives with leaf flag
+      };
+
+      FlatOutput (BVH* bvh, size_t maxPrimitives)
+        : bvh(bvh), nodes(nullptr), leafPrims(nullptr), numNodes(1)
+      {
+        /* every leaf references at least one primitive, thus there are at most 2*N-1 nodes */
+        if (maxPrimitives >= RTC_FLAT_BVH_LEAF_FLAG/2)
+          throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"too many primitives for flat BVH nodes");
+        bvh->flat_nodes.resize(max(size_t(1),2*maxPrimitives));
+        nodes = bvh->flat_nodes.data();
+      }
+
+      /* reserves consecutive nodes for all children of a node */
+      __forceinline NodeRef createNode(const FastAllocator::CachedAllocator& alloc, size_t N) {
+        return NodeRef(numNodes.fetch_add(N),N);
+      }
+
+      __forceinline void setBounds(NodeRef node, const RTCBounds** bounds, size_t N) const
+      {
+        for (size_t i=0; i<N; i++) {
+          RTCFlatBVHNode& child = nodes[node.offset+i];
+          child.lower_x = bounds[i]->lower_x; child.lower_y = bounds[i]->lower_y; child.lower_z = bounds[i]->lower_z;
+          child.upper_x = bounds[i]->upper_x; child.upper_y = bounds[i]->upper_y; child.upper_z = bounds[i]->upper_z;
+        }
+      }
+
+      __forceinline void setChildren(NodeRef node, NodeRef* children, size_t N) const
+      {
+        for (size_t i=0; i<N; i++) {
+          nodes[node.offset+i].offset = children[i].offset;
+          nodes[node.offset+i].count  = children[i].count;
+        }
+      }
+
+      __forceinline NodeRef createLeaf(const FastAllocator::CachedAllocator& alloc, const RTCBuildPrimitive* prims, size_t begin, size_t N) const
+      {
+        if (leafPrims)
+          for (size_t i=0; i<N; i++) leafPrims[begin+i] = prims[i];
+        return NodeRef(begin,N | RTC_FLAT_BVH_LEAF_FLAG);
+      }
+
+      /* builders that do not sort the primitive array in place gather the primitives
+       * of each leaf into a temporary array, which gets copied back after the build */
+      void beginReorder(size_t N)
+      {
+        bvh->flat_prims.resize(N);
+        leafPrims = bvh->flat_prims.data();
+      }
+
+      void endReorder(RTCBuildPrimitive* prims, size_t N)
+      {
+        parallel_for(size_t(0), N, size_t(4096), [&](const range<size_t>& r) {
+            memcpy((void*)(prims+r.begin()),(void*)(leafPrims+r.begin()),r.size()*sizeof(RTCBuildPrimitive));
+          });
+        leafPrims = nullptr;
+      }
+
+      void* finish(NodeRef root, const BBox3fa& bounds)
+      {
+        const RTCBounds* pbounds = (const RTCBounds*) &bounds;
+        setBounds(NodeRef(0,1),&pbounds,1);
+        setChildren(NodeRef(0,1),&root,1);
+        bvh->numFlatNodes = numNodes;
+        return nodes;
+      }
+
+      BVH* bvh;
+      RTCFlatBVHNode* nodes;
+      RTCBuildPrimitive* leafPrims;
+      std::atomic<size_t> numNodes;
+    };
+
+    template<typename BuildPrim, typename Output>
+    void* rtcBuildBVHMorton(const RTCBuildArguments* arguments, mvector<BuildPrim>& morton_src, mvector<BuildPrim>& morton_tmp, Output& output)
+    {
+      typedef typename BuildPrim::Mapping MortonCodeMapping;
+      typedef typename BuildPrim::Generator MortonCodeGenerator;
+      typedef typename Output::NodeRef NodeRef;
+
       BVH* bvh = (BVH*) arguments->bvh;
       RTCBuildPrimitive* prims_i =  arguments->primitives;
       size_t primitiveCount = arguments->primitiveCount;
-      RTCCreateNodeFunction createNode = arguments->createNode;
-      RTCSetNodeChildrenFunction setNodeChildren = arguments->setNodeChildren;
-      RTCSetNodeBoundsFunction setNodeBounds = arguments->setNodeBounds;
-      RTCCreateLeafFunction createLeaf = arguments->createLeaf;
       RTCProgressMonitorFunction buildProgress = arguments->buildProgress;
       void* userPtr = arguments->userPtr;
         
@@ -51,8 +197,6 @@ namespace embree
       
       /* initialize temporary arrays for morton builder */
       PrimRef* prims = (PrimRef*) prims_i;
-      mvector<BVHBuilderMorton::BuildPrim>& morton_src = bvh->morton_src;
-      mvector<BVHBuilderMorton::BuildPrim>& morton_tmp = bvh->morton_tmp;
       morton_src.resize(primitiveCount);
       morton_tmp.resize(primitiveCount);
 
@@ -66,16 +210,17 @@ namespace embree
         }, BBox3fa::merge);
       
       /* compute morton codes */
-      BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
+      MortonCodeMapping mapping(centBounds);
       parallel_for ( size_t(0), primitiveCount, [&](const range<size_t>& r) {
-          BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton_src[r.begin()]);
+          MortonCodeGenerator generator(mapping,&morton_src[r.begin()]);
           for (size_t i=r.begin(); i<r.end(); i++) {
             generator(prims[i].bounds(),(unsigned) i);
           }
         });
 
       /* start morton build */
-      std::pair<void*,BBox3fa> root = BVHBuilderMorton::build<std::pair<void*,BBox3fa>>(
+      output.beginReorder(primitiveCount);
+      std::pair<NodeRef,BBox3fa> root = BVHBuilderMorton::build<std::pair<NodeRef,BBox3fa>>(
         
         /* thread local allocator for fast allocations */
         [&] () -> FastAllocator::CachedAllocator { 
@@ -83,28 +228,28 @@ namespace embree
         },
         
         /* lambda function that allocates BVH nodes */
-        [&] ( const FastAllocator::CachedAllocator& alloc, size_t N ) -> void* {
-          return createNode((RTCThreadLocalAllocator)&alloc, (unsigned int)N,userPtr);
+        [&] ( const FastAllocator::CachedAllocator& alloc, size_t N ) -> NodeRef {
+          return output.createNode(alloc,N);
         },
         
         /* lambda function that sets bounds */
-        [&] (void* node, const std::pair<void*,BBox3fa>* children, size_t N) -> std::pair<void*,BBox3fa>
+        [&] (NodeRef node, const std::pair<NodeRef,BBox3fa>* children, size_t N) -> std::pair<NodeRef,BBox3fa>
         {
           BBox3fa bounds = empty;
-          void* childptrs[BVHBuilderMorton::MAX_BRANCHING_FACTOR];
+          NodeRef childptrs[BVHBuilderMorton::MAX_BRANCHING_FACTOR];
           const RTCBounds* cbounds[BVHBuilderMorton::MAX_BRANCHING_FACTOR];
           for (size_t i=0; i<N; i++) {
             bounds.extend(children[i].second);
             childptrs[i] = children[i].first;
             cbounds[i] = (const RTCBounds*)&children[i].second;
           }
-          setNodeBounds(node,cbounds,(unsigned int)N,userPtr);
-          setNodeChildren(node,childptrs, (unsigned int)N,userPtr);
+          output.setBounds(node,cbounds,N);
+          output.setChildren(node,childptrs,N);
           return std::make_pair(node,bounds);
         },
         
         /* lambda function that creates BVH leaves */
-        [&]( const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc) -> std::pair<void*,BBox3fa>
+        [&]( const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc) -> std::pair<NodeRef,BBox3fa>
         {
 	  RTCBuildPrimitive localBuildPrims[RTC_BUILD_MAX_PRIMITIVES_PER_LEAF];
 	  BBox3fa bounds = empty;
@@ -114,12 +259,12 @@ namespace embree
 	      bounds.extend(prims[id].bounds());
 	      localBuildPrims[i] = prims_i[id];
 	    }
-          void* node = createLeaf((RTCThreadLocalAllocator)&alloc,localBuildPrims,current.size(),userPtr);
+          NodeRef node = output.createLeaf(alloc,localBuildPrims,current.begin(),current.size());
           return std::make_pair(node,bounds);
         },
         
         /* lambda that calculates the bounds for some primitive */
-        [&] (const BVHBuilderMorton::BuildPrim& morton) -> BBox3fa {
+        [&] (const BuildPrim& morton) -> BBox3fa {
           return prims[morton.index].bounds();
         },
         
@@ -134,19 +279,19 @@ namespace embree
         morton_src.data(),morton_tmp.data(),primitiveCount,
         *arguments);
 
+      output.endReorder(prims_i,primitiveCount);
       bvh->allocator.cleanup();
-      return root.first;
+      return output.finish(root.first,root.second);
     }
 
-    void* rtcBuildBVHBinnedSAH(const RTCBuildArguments* arguments)
+    template<typename Output>
+    void* rtcBuildBVHBinnedSAH(const RTCBuildArguments* arguments, Output& output)
     {
+      typedef typename Output::NodeRef NodeRef;
+
       BVH* bvh = (BVH*) arguments->bvh;
       RTCBuildPrimitive* prims =  arguments->primitives;
       size_t primitiveCount = arguments->primitiveCount;
-      RTCCreateNodeFunction createNode = arguments->createNode;
-      RTCSetNodeChildrenFunction setNodeChildren = arguments->setNodeChildren;
-      RTCSetNodeBoundsFunction setNodeBounds = arguments->setNodeBounds;
-      RTCCreateLeafFunction createLeaf = arguments->createLeaf;
       RTCProgressMonitorFunction buildProgress = arguments->buildProgress;
       void* userPtr = arguments->userPtr;
       
@@ -166,7 +311,7 @@ namespace embree
       const PrimInfo pinfo(0,primitiveCount,bounds);
       
       /* build BVH */
-      void* root = BVHBuilderBinnedSAH::build<void*>(
+      NodeRef root = BVHBuilderBinnedSAH::build<NodeRef>(
         
         /* thread local allocator for fast allocations */
         [&] () -> FastAllocator::CachedAllocator { 
@@ -174,24 +319,24 @@ namespace embree
         },
 
         /* lambda function that creates BVH nodes */
-        [&](BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, const FastAllocator::CachedAllocator& alloc) -> void*
+        [&](BVHBuilderBinnedSAH::BuildRecord* children, const size_t N, const FastAllocator::CachedAllocator& alloc) -> NodeRef
         {
-          void* node = createNode((RTCThreadLocalAllocator)&alloc, (unsigned int)N,userPtr);
+          NodeRef node = output.createNode(alloc,N);
           const RTCBounds* cbounds[GeneralBVHBuilder::MAX_BRANCHING_FACTOR];
           for (size_t i=0; i<N; i++) cbounds[i] = (const RTCBounds*) &children[i].prims.geomBounds;
-          setNodeBounds(node,cbounds, (unsigned int)N,userPtr);
+          output.setBounds(node,cbounds,N);
           return node;
         },
 
         /* lambda function that updates BVH nodes */
-        [&](const BVHBuilderBinnedSAH::BuildRecord& precord, const BVHBuilderBinnedSAH::BuildRecord* crecords, void* node, void** children, const size_t N) -> void* {
-          setNodeChildren(node,children, (unsigned int)N,userPtr);
+        [&](const BVHBuilderBinnedSAH::BuildRecord& precord, const BVHBuilderBinnedSAH::BuildRecord* crecords, NodeRef node, NodeRef* children, const size_t N) -> NodeRef {
+          output.setChildren(node,children,N);
           return node;
         },
         
         /* lambda function that creates BVH leaves */
-        [&](const PrimRef* prims, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> void* {
-          return createLeaf((RTCThreadLocalAllocator)&alloc,(RTCBuildPrimitive*)(prims+range.begin()),range.size(),userPtr);
+        [&](const PrimRef* prims, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+          return output.createLeaf(alloc,(RTCBuildPrimitive*)(prims+range.begin()),range.begin(),range.size());
         },
         
         /* progress monitor function */
@@ -205,7 +350,7 @@ namespace embree
         (PrimRef*)prims,pinfo,*arguments);
         
       bvh->allocator.cleanup();
-      return root;
+      return output.finish(root,bounds.geomBounds);
     }
 
     static __forceinline const std::pair<CentGeomBBox3fa,unsigned int> mergePair(const std::pair<CentGeomBBox3fa,unsigned int>& a, const std::pair<CentGeomBBox3fa,unsigned int>& b) {
@@ -214,16 +359,121 @@ namespace embree
       return std::pair<CentGeomBBox3fa,unsigned int>(centBounds,maxGeomID);
     }
 
-    void* rtcBuildBVHSpatialSAH(const RTCBuildArguments* arguments)
+    /* triangles passed with the build arguments, the primID of a build primitive selects its triangle */
+    struct BuildTriangles
+    {
+      BuildTriangles (const RTCBuildArguments* arguments)
+        : vertices((const char*)arguments->vertices), vertexStride(arguments->vertexStride), indices(arguments->indices) {}
+
+      __forceinline Vec3fa vertex(size_t i) const {
+        const float* v = (const float*)(vertices + i*vertexStride);
+        return Vec3fa(v[0],v[1],v[2]);
+      }
+
+      /* returns the vertices of a triangle, the first vertex is repeated at the end */
+      __forceinline void triangle(unsigned int primID, Vec3fa (&v)[4]) const
+      {
+        for (size_t i=0; i<3; i++)
+          v[i] = vertex(indices ? indices[3*size_t(primID)+i] : 3*size_t(primID)+i);
+        v[3] = v[0];
+      }
+
+      __forceinline float projectedArea(unsigned int primID) const
+      {
+        Vec3fa v[4]; triangle(primID,v);
+        return areaProjectedTriangle(v[0],v[1],v[2]);
+      }
+
+      const char* vertices;
+      size_t vertexStride;
+      const unsigned int* indices;
+    };
+
+    /* splits a build primitive through the split function of the application */
+    struct UserSplitter
+    {
+      UserSplitter (RTCSplitPrimitiveFunction splitPrimitive, unsigned geomID, unsigned primID, void* userPtr)
+        : splitPrimitive(splitPrimitive), geomID(geomID), primID(primID), userPtr(userPtr) {}
+      
+      __forceinline void operator() (PrimRef& prim, const size_t dim, const float pos, PrimRef& left_o, PrimRef& right_o) const 
+      {
+        prim.geomIDref() &= BVHBuilderBinnedFastSpatialSAH::GEOMID_MASK;
+        splitPrimitive((RTCBuildPrimitive*)&prim,(unsigned)dim,pos,(RTCBounds*)&left_o,(RTCBounds*)&right_o,userPtr);
+        left_o.geomIDref()  = geomID; left_o.primIDref()  = primID;
+        right_o.geomIDref() = geomID; right_o.primIDref() = primID;
+      }
+
+      __forceinline void operator() (const BBox3fa& box, const size_t dim, const float pos, BBox3fa& left_o, BBox3fa& right_o) const 
+      {
+        PrimRef prim(box,geomID & BVHBuilderBinnedFastSpatialSAH::GEOMID_MASK,primID);
+        splitPrimitive((RTCBuildPrimitive*)&prim,(unsigned)dim,pos,(RTCBounds*)&left_o,(RTCBounds*)&right_o,userPtr);
+      }
+ 
+      RTCSplitPrimitiveFunction splitPrimitive;
+      unsigned geomID;
+      unsigned primID;
+      void* userPtr;
+    };
+
+    /* splits a triangle passed with the build arguments, the vertices are fetched once per primitive */
+    struct BuildTriangleSplitter
+    {
+      __forceinline BuildTriangleSplitter (const BuildTriangles& triangles, const PrimRef& prim) {
+        triangles.triangle(prim.primID(),v);
+      }
+
+      __forceinline void operator() (const PrimRef& prim, const size_t dim, const float pos, PrimRef& left_o, PrimRef& right_o) const {
+        splitPolygon<3>(prim,dim,pos,v,left_o,right_o);
+      }
+
+      __forceinline void operator() (const BBox3fa& prim, const size_t dim, const float pos, BBox3fa& left_o, BBox3fa& right_o) const {
+        splitPolygon<3>(prim,dim,pos,v,left_o,right_o);
+      }
+
+      Vec3fa v[4];
+    };
+
+    /* splits triangles into the unused part of the primitive array before the build and returns the new number of primitives */
+    static size_t presplitTriangles(const RTCBuildArguments* arguments, const BuildTriangles& triangles)
+    {
+      PrimRef* prims = (PrimRef*) arguments->primitives;
+      const size_t primitiveCount = arguments->primitiveCount;
+
+      /* view onto the entire primitive array */
+      struct PrimRefArray
+      {
+        __forceinline size_t size() const { return capacity; }
+        __forceinline PrimRef& operator[] (size_t i) const { return prims[i]; }
+        PrimRef* prims;
+        size_t capacity;
+      } primArray = { prims, arguments->primitiveArrayCapacity };
+
+      const PrimInfo pinfo = parallel_reduce(size_t(0),primitiveCount,size_t(1024),size_t(1024),PrimInfo(empty), [&](const range<size_t>& r) -> PrimInfo {
+          PrimInfo pinfo(empty);
+          for (size_t i=r.begin(); i<r.end(); i++)
+            pinfo.add_center2(prims[i]);
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+
+      auto splitPrim = [&] (const PrimRef& prim, const unsigned int splitprims, const SplittingGrid& grid, PrimRef subPrims[MAX_PRESPLITS_PER_PRIMITIVE], unsigned int& numSubPrims) {
+        splitPrimitive(BuildTriangleSplitter(triangles,prim),prim,splitprims,grid,subPrims,numSubPrims);
+      };
+
+      auto primitiveArea = [&] (const PrimRef& prim) {
+        return triangles.projectedArea(prim.primID());
+      };
+
+      return createPrimRefArray_presplit(primitiveCount,primArray,pinfo,splitPrim,primitiveArea).size();
+    }
+
+    template<typename Output, typename CreateSplitterFunc>
+    void* rtcBuildBVHSpatialSAH(const RTCBuildArguments* arguments, Output& output, const CreateSplitterFunc& createSplitter)
     {
+      typedef typename Output::NodeRef NodeRef;
+
       BVH* bvh = (BVH*) arguments->bvh;
       RTCBuildPrimitive* prims =  arguments->primitives;
       size_t primitiveCount = arguments->primitiveCount;
-      RTCCreateNodeFunction createNode = arguments->createNode;
-      RTCSetNodeChildrenFunction setNodeChildren = arguments->setNodeChildren;
-      RTCSetNodeBoundsFunction setNodeBounds = arguments->setNodeBounds;
-      RTCCreateLeafFunction createLeaf = arguments->createLeaf;
-      RTCSplitPrimitiveFunction splitPrimitive = arguments->splitPrimitive;
       RTCProgressMonitorFunction buildProgress = arguments->buildProgress;
       void* userPtr = arguments->userPtr;
       
@@ -253,39 +503,13 @@ namespace embree
       if (unlikely(maxGeomID >= ((unsigned int)1 << (32-RESERVED_NUM_SPATIAL_SPLITS_GEOMID_BITS))))
         {
           /* fallback code for max geomID larger than threshold */
-          return rtcBuildBVHBinnedSAH(arguments);
+          return rtcBuildBVHBinnedSAH(arguments,output);
         }
 
       const PrimInfo pinfo(0,primitiveCount,bounds);
 
-      /* function that splits a build primitive */
-      struct Splitter
-      {
-        Splitter (RTCSplitPrimitiveFunction splitPrimitive, unsigned geomID, unsigned primID, void* userPtr)
-          : splitPrimitive(splitPrimitive), geomID(geomID), primID(primID), userPtr(userPtr) {}
-        
-        __forceinline void operator() (PrimRef& prim, const size_t dim, const float pos, PrimRef& left_o, PrimRef& right_o) const 
-        {
-          prim.geomIDref() &= BVHBuilderBinnedFastSpatialSAH::GEOMID_MASK;
-          splitPrimitive((RTCBuildPrimitive*)&prim,(unsigned)dim,pos,(RTCBounds*)&left_o,(RTCBounds*)&right_o,userPtr);
-          left_o.geomIDref()  = geomID; left_o.primIDref()  = primID;
-          right_o.geomIDref() = geomID; right_o.primIDref() = primID;
-        }
-
-        __forceinline void operator() (const BBox3fa& box, const size_t dim, const float pos, BBox3fa& left_o, BBox3fa& right_o) const 
-        {
-          PrimRef prim(box,geomID & BVHBuilderBinnedFastSpatialSAH::GEOMID_MASK,primID);
-          splitPrimitive((RTCBuildPrimitive*)&prim,(unsigned)dim,pos,(RTCBounds*)&left_o,(RTCBounds*)&right_o,userPtr);
-        }
-   
-        RTCSplitPrimitiveFunction splitPrimitive;
-        unsigned geomID;
-        unsigned primID;
-        void* userPtr;
-      };
-
       /* build BVH */
-      void* root = BVHBuilderBinnedFastSpatialSAH::build<void*>(
+      NodeRef root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
         
         /* thread local allocator for fast allocations */
         [&] () -> FastAllocator::CachedAllocator { 
@@ -293,30 +517,28 @@ namespace embree
         },
 
         /* lambda function that creates BVH nodes */
-        [&] (BVHBuilderBinnedFastSpatialSAH::BuildRecord* children, const size_t N, const FastAllocator::CachedAllocator& alloc) -> void*
+        [&] (BVHBuilderBinnedFastSpatialSAH::BuildRecord* children, const size_t N, const FastAllocator::CachedAllocator& alloc) -> NodeRef
         {
-          void* node = createNode((RTCThreadLocalAllocator)&alloc, (unsigned int)N,userPtr);
+          NodeRef node = output.createNode(alloc,N);
           const RTCBounds* cbounds[GeneralBVHBuilder::MAX_BRANCHING_FACTOR];
           for (size_t i=0; i<N; i++) cbounds[i] = (const RTCBounds*) &children[i].prims.geomBounds;
-          setNodeBounds(node,cbounds, (unsigned int)N,userPtr);
+          output.setBounds(node,cbounds,N);
           return node;
         },
 
         /* lambda function that updates BVH nodes */
-        [&] (const BVHBuilderBinnedFastSpatialSAH::BuildRecord& precord, const BVHBuilderBinnedFastSpatialSAH::BuildRecord* crecords, void* node, void** children, const size_t N) -> void* {
-          setNodeChildren(node,children, (unsigned int)N,userPtr);
+        [&] (const BVHBuilderBinnedFastSpatialSAH::BuildRecord& precord, const BVHBuilderBinnedFastSpatialSAH::BuildRecord* crecords, NodeRef node, NodeRef* children, const size_t N) -> NodeRef {
+          output.setChildren(node,children,N);
           return node;
         },
         
         /* lambda function that creates BVH leaves */
-        [&] (const PrimRef* prims, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> void* {
-          return createLeaf((RTCThreadLocalAllocator)&alloc,(RTCBuildPrimitive*)(prims+range.begin()),range.size(),userPtr);
+        [&] (const PrimRef* prims, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+          return output.createLeaf(alloc,(RTCBuildPrimitive*)(prims+range.begin()),range.begin(),range.size());
         },
         
         /* returns the splitter */
-        [&] ( const PrimRef& prim ) -> Splitter {
-          return Splitter(splitPrimitive,prim.geomID(),prim.primID(),userPtr);
-        },
+        createSplitter,
 
         /* progress monitor function */
         [&] (size_t dn) {
@@ -331,7 +553,526 @@ namespace embree
         pinfo,*arguments);
         
       bvh->allocator.cleanup();
-      return root;
+      return output.finish(root,bounds.geomBounds);
+    }
+
+    /* calculates the linear bounds of build primitives for some time range through the callback of the application */
+    struct UserRecalculatePrimRef
+    {
+      UserRecalculatePrimRef (const RTCBuildArguments* arguments)
+        : linearBoundsFunc(arguments->primitiveLinearBounds), userPtr(arguments->userPtr) {}
+
+      __forceinline LBBox3fa linearBounds(const RTCBuildPrimitive& prim, const BBox1f time_range) const
+      {
+        RTCLinearBounds lbounds;
+        linearBoundsFunc(&prim,time_range.lower,time_range.upper,&lbounds,userPtr);
+        return LBBox3fa((BBox3fa&)lbounds.bounds0,(BBox3fa&)lbounds.bounds1);
+      }
+
+      __forceinline LBBox3fa linearBounds(const PrimRefMB& prim, const BBox1f time_range) const
+      {
+        RTCBuildPrimitive bprim;
+        (BBox3fa&)bprim = prim.bounds().bounds();
+        bprim.geomID = prim.geomID();
+        bprim.primID = prim.primID();
+        return linearBounds(bprim,time_range);
+      }
+
+      __forceinline PrimRefMB operator() (const PrimRefMB& prim, const BBox1f time_range) const
+      {
+        const range<int> tbounds = prim.timeSegmentRange(time_range);
+        return PrimRefMB(linearBounds(prim,time_range),tbounds.size(),prim.time_range,prim.totalTimeSegments(),prim.geomID(),prim.primID());
+      }
+
+      RTCPrimitiveLinearBoundsFunction linearBoundsFunc;
+      void* userPtr;
+    };
+
+    void* rtcBuildBVHMSMBlur(const RTCBuildArguments* arguments)
+    {
+      typedef BVHNodeRecordMB4D<void*> NodeRecordMB4D;
+
+      BVH* bvh = (BVH*) arguments->bvh;
+      RTCBuildPrimitive* prims_i =  arguments->primitives;
+      size_t primitiveCount = arguments->primitiveCount;
+      const unsigned int numTimeSegments = arguments->timeSegmentCount;
+      RTCCreateNodeFunction createNode = arguments->createNode;
+      RTCSetNodeChildrenFunction setNodeChildren = arguments->setNodeChildren;
+      RTCSetNodeLinearBoundsFunction setNodeLinearBounds = arguments->setNodeLinearBounds;
+      RTCCreateLeafFunction createLeaf = arguments->createLeaf;
+      RTCProgressMonitorFunction buildProgress = arguments->buildProgress;
+      void* userPtr = arguments->userPtr;
+
+      std::atomic<size_t> progress(0);
+      const UserRecalculatePrimRef recalculatePrimRef(arguments);
+
+      /* create primitive references for the entire time range */
+      mvector<PrimRefMB> prims(bvh->device,primitiveCount);
+      PrimInfoMB pinfo = parallel_reduce(size_t(0),primitiveCount,size_t(1024),size_t(1024),PrimInfoMB(empty), [&](const range<size_t>& r) -> PrimInfoMB {
+          PrimInfoMB pinfo(empty);
+          for (size_t i=r.begin(); i<r.end(); i++) {
+            const LBBox3fa lbounds = recalculatePrimRef.linearBounds(prims_i[i],BBox1f(0.0f,1.0f));
+            prims[i] = PrimRefMB(lbounds,numTimeSegments,BBox1f(0.0f,1.0f),numTimeSegments,prims_i[i].geomID,prims_i[i].primID);
+            pinfo.add_primref(prims[i]);
+          }
+          return pinfo;
+        }, PrimInfoMB::merge2);
+      pinfo.time_range = BBox1f(0.0f,1.0f);
+
+      /* settings for BVH build */
+      BVHBuilderMSMBlur::Settings settings;
+      settings.branchingFactor = arguments->maxBranchingFactor;
+      settings.maxDepth = arguments->maxDepth;
+      settings.logBlockSize = bsr(size_t(max(arguments->sahBlockSize,1u)));
+      settings.maxLeafSize = min(size_t(arguments->maxLeafSize),size_t(RTC_BUILD_MAX_PRIMITIVES_PER_LEAF));
+      settings.minLeafSize = min(size_t(arguments->minLeafSize),settings.maxLeafSize);
+      settings.travCost = arguments->traversalCost;
+      settings.intCost = arguments->intersectionCost;
+
+      /* build BVH */
+      NodeRecordMB4D root = BVHBuilderMSMBlur::build<void*>(prims,pinfo,bvh->device,recalculatePrimRef,
+
+        /* thread local allocator for fast allocations */
+        [&] () -> FastAllocator::CachedAllocator { 
+          return bvh->allocator.getCachedAllocator();
+        },
+
+        /* lambda function that creates BVH nodes */
+        [&] (const BVHBuilderMSMBlur::BuildRecord* children, const size_t N, const FastAllocator::CachedAllocator& alloc, bool hasTimeSplits) -> void* {
+          return createNode((RTCThreadLocalAllocator)&alloc,(unsigned int)N,userPtr);
+        },
+
+        /* lambda function that sets the children and their linear bounds */
+        [&] (const BVHBuilderMSMBlur::BuildRecord& precord, const BVHBuilderMSMBlur::BuildRecord* crecords, void* node, const NodeRecordMB4D* children, const size_t N)
+        {
+          void* childptrs[GeneralBVHBuilder::MAX_BRANCHING_FACTOR];
+          const RTCLinearBounds* cbounds[GeneralBVHBuilder::MAX_BRANCHING_FACTOR];
+          RTCTimeRange ctimes[GeneralBVHBuilder::MAX_BRANCHING_FACTOR];
+          for (size_t i=0; i<N; i++) {
+            childptrs[i] = children[i].ref;
+            cbounds[i] = (const RTCLinearBounds*) &children[i].lbounds;
+            ctimes[i].lower = children[i].dt.lower;
+            ctimes[i].upper = children[i].dt.upper;
+          }
+          setNodeLinearBounds(node,cbounds,ctimes,(unsigned int)N,userPtr);
+          setNodeChildren(node,childptrs,(unsigned int)N,userPtr);
+        },
+
+        /* lambda function that creates BVH leaves */
+        [&] (const BVHBuilderMSMBlur::BuildRecord& current, const FastAllocator::CachedAllocator& alloc) -> NodeRecordMB4D
+        {
+          RTCBuildPrimitive localBuildPrims[RTC_BUILD_MAX_PRIMITIVES_PER_LEAF];
+          LBBox3fa bounds = empty;
+          for (size_t i=0; i<current.size(); i++)
+          {
+            const PrimRefMB& prim = (*current.prims.prims)[current.prims.begin()+i];
+            const LBBox3fa lbounds = recalculatePrimRef.linearBounds(prim,current.prims.time_range);
+            bounds.extend(lbounds);
+            (BBox3fa&)localBuildPrims[i] = lbounds.bounds();
+            localBuildPrims[i].geomID = prim.geomID();
+            localBuildPrims[i].primID = prim.primID();
+          }
+          void* node = createLeaf((RTCThreadLocalAllocator)&alloc,localBuildPrims,current.size(),userPtr);
+          return NodeRecordMB4D(node,bounds,current.prims.time_range);
+        },
+
+        /* progress monitor function */
+        [&] (size_t dn) {
+          if (!buildProgress) return true;
+          const size_t n = progress.fetch_add(dn)+dn;
+          const double f = std::min(1.0,double(n)/double(primitiveCount));
+          return buildProgress(userPtr,f);
+        },
+
+        settings);
+
+      bvh->allocator.cleanup();
+      return root.ref;
+    }
+
+    template<typename Output>
+    void* rtcBuildBVH(const RTCBuildArguments* arguments, Output& output)
+    {
+      BVH* bvh = (BVH*) arguments->bvh;
+
+      /* switch between different builders based on quality level */
+      if (arguments->buildQuality == RTC_BUILD_QUALITY_LOW) {
+        if (arguments->buildFlags & RTC_BUILD_FLAG_MORTON_64)
+          return rtcBuildBVHMorton(arguments,bvh->morton64_src,bvh->morton64_tmp,output);
+        else
+          return rtcBuildBVHMorton(arguments,bvh->morton_src,bvh->morton_tmp,output);
+      }
+      else if (arguments->buildQuality == RTC_BUILD_QUALITY_MEDIUM)
+        return rtcBuildBVHBinnedSAH(arguments,output);
+      else if (arguments->buildQuality == RTC_BUILD_QUALITY_HIGH) {
+        const bool triangles = arguments->vertices != nullptr;
+        if ((arguments->splitPrimitive == nullptr && !triangles) || arguments->primitiveArrayCapacity <= arguments->primitiveCount)
+          return rtcBuildBVHBinnedSAH(arguments,output);
+        else if (triangles && (arguments->buildFlags & RTC_BUILD_FLAG_PRESPLITS))
+        {
+          RTCBuildArguments args = *arguments;
+          args.primitiveCount = presplitTriangles(arguments,BuildTriangles(arguments));
+          return rtcBuildBVHBinnedSAH(&args,output);
+        }
+        else if (arguments->splitPrimitive == nullptr)
+        {
+          const BuildTriangles triangles(arguments);
+          return rtcBuildBVHSpatialSAH(arguments,output,[&] (const PrimRef& prim) {
+              return BuildTriangleSplitter(triangles,prim);
+            });
+        }
+        else
+        {
+          return rtcBuildBVHSpatialSAH(arguments,output,[&] (const PrimRef& prim) {
+              return UserSplitter(arguments->splitPrimitive,prim.geomID(),prim.primID(),arguments->userPtr);
+            });
+        }
+      }
+      else
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid build quality");
+    }
+
+    /* incrementally updates a BVH built with RTC_BUILD_FLAG_INCREMENTAL, the leaves of the
+     * flat nodes reference a primitive array owned by the updater */
+    struct FlatBVHUpdater
+    {
+      static const unsigned int INVALID = 0xFFFFFFFF;
+
+      FlatBVHUpdater (BVH* bvh, const RTCBuildArguments* arguments)
+        : bvh(bvh), arguments(*arguments), prims(bvh->device,0), numUpdates(0), validPrimSlots(false) {}
+
+      __forceinline RTCFlatBVHNode& node(size_t i) const { return bvh->flat_nodes[i]; }
+      __forceinline bool isLeaf(size_t i) const { return node(i).count & RTC_FLAT_BVH_LEAF_FLAG; }
+      __forceinline unsigned int numItems(size_t i) const { return node(i).count & ~RTC_FLAT_BVH_LEAF_FLAG; }
+
+      __forceinline BBox3fa bounds(size_t i) const {
+        const RTCFlatBVHNode& n = node(i);
+        return BBox3fa(Vec3fa(n.lower_x,n.lower_y,n.lower_z),Vec3fa(n.upper_x,n.upper_y,n.upper_z));
+      }
+
+      __forceinline void setBounds(size_t i, const BBox3fa& b) const {
+        RTCFlatBVHNode& n = node(i);
+        n.lower_x = b.lower.x; n.lower_y = b.lower.y; n.lower_z = b.lower.z;
+        n.upper_x = b.upper.x; n.upper_y = b.upper.y; n.upper_z = b.upper.z;
+      }
+
+      static __forceinline BBox3fa primBounds(const RTCBuildPrimitive& prim) {
+        return BBox3fa(Vec3fa(prim.lower_x,prim.lower_y,prim.lower_z),Vec3fa(prim.upper_x,prim.upper_y,prim.upper_z));
+      }
+
+      static __forceinline uint64_t primKey(const RTCBuildPrimitive& prim) {
+        return (uint64_t(prim.geomID) << 32) | uint64_t(prim.primID);
+      }
+
+      __forceinline size_t numPrimitives() const {
+        return prims.size()-freePrims.size();
+      }
+
+      /* builds the flat nodes over all primitives */
+      void build()
+      {
+        if (prims.size() == 0)
+        {
+          bvh->flat_nodes.resize(1);
+          node(0).offset = 0;
+          node(0).count = RTC_FLAT_BVH_LEAF_FLAG;
+          setBounds(0,empty);
+          bvh->numFlatNodes = 1;
+        }
+        else
+        {
+          RTCBuildArguments args = arguments;
+          args.primitives = prims.data();
+          args.primitiveCount = args.primitiveArrayCapacity = prims.size();
+          bvh->allocator.init_estimate(prims.size()*sizeof(BBox3fa));
+          bvh->allocator.reset();
+          FlatOutput output(bvh,prims.size());
+          rtcBuildBVH(&args,output);
+          if (!(arguments.buildFlags & RTC_BUILD_FLAG_DYNAMIC))
+            bvh->clearTemporaryData();
+        }
+
+        /* link the nodes to their parents and the primitives to their leaves */
+        parents.assign(bvh->flat_nodes.size(),INVALID);
+        primLeaves.assign(prims.size(),INVALID);
+        parallel_for(size_t(0), bvh->numFlatNodes, size_t(4096), [&](const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) updateReferences((unsigned int)i);
+          });
+
+        freeNodePairs.clear();
+        freePrims.clear();
+        primSlots.clear();
+        validPrimSlots = false;
+        numUpdates = 0;
+      }
+
+      /* rebuilds the BVH after many updates, as the local updates degrade its quality */
+      void rebuildIfDegraded()
+      {
+        if (numUpdates <= numPrimitives()/4)
+          return;
+
+        size_t n = 0;
+        for (size_t i=0; i<prims.size(); i++)
+          if (primLeaves[i] != INVALID) prims[n++] = prims[i];
+        prims.resize(n);
+        build();
+      }
+
+      /* updates the parent of the children or the leaf of the primitives of a node */
+      __forceinline void updateReferences(unsigned int i)
+      {
+        const RTCFlatBVHNode& n = node(i);
+        if (isLeaf(i)) {
+          for (size_t j=0; j<numItems(i); j++) primLeaves[n.offset+j] = i;
+        } else {
+          for (size_t j=0; j<n.count; j++) parents[n.offset+j] = i;
+        }
+      }
+
+      __forceinline void moveNode(unsigned int src, unsigned int dst)
+      {
+        node(dst) = node(src);
+        updateReferences(dst);
+      }
+
+      __forceinline void swapNodes(unsigned int a, unsigned int b)
+      {
+        std::swap(node(a),node(b));
+        updateReferences(a);
+        updateReferences(b);
+      }
+
+      unsigned int allocPrimitive()
+      {
+        if (freePrims.size()) {
+          const unsigned int slot = freePrims.back();
+          freePrims.pop_back();
+          return slot;
+        }
+        prims.push_back(RTCBuildPrimitive());
+        primLeaves.push_back(INVALID);
+        return (unsigned int)(prims.size()-1);
+      }
+
+      unsigned int allocNodePair()
+      {
+        if (freeNodePairs.size()) {
+          const unsigned int pair = freeNodePairs.back();
+          freeNodePairs.pop_back();
+          return pair;
+        }
+        const size_t pair = bvh->numFlatNodes;
+        if (pair+2 >= RTC_FLAT_BVH_LEAF_FLAG)
+          throw_RTCError(RTC_ERROR_OUT_OF_MEMORY,"too many flat BVH nodes");
+        bvh->numFlatNodes += 2;
+        if (bvh->flat_nodes.size() < bvh->numFlatNodes) bvh->flat_nodes.resize(bvh->numFlatNodes);
+        if (parents.size() < bvh->numFlatNodes) parents.resize(bvh->numFlatNodes,INVALID);
+        return (unsigned int)pair;
+      }
+
+      void initPrimSlots()
+      {
+        primSlots.clear();
+        primSlots.reserve(prims.size());
+        for (size_t i=0; i<prims.size(); i++)
+          if (primLeaves[i] != INVALID) primSlots[primKey(prims[i])] = (unsigned int)i;
+        validPrimSlots = true;
+      }
+
+      /* descends to the node that has the lowest SAH cost when paired with a new leaf */
+      unsigned int findSibling(const BBox3fa& b) const
+      {
+        unsigned int i = 0;
+        while (!isLeaf(i))
+        {
+          const float area = halfArea(bounds(i));
+          const float combinedArea = halfArea(merge(bounds(i),b));
+          const float inheritanceCost = combinedArea-area;
+
+          unsigned int bestChild = INVALID;
+          float bestCost = combinedArea;
+          for (unsigned int j=0; j<node(i).count; j++)
+          {
+            const unsigned int child = node(i).offset+j;
+            const float childArea = halfArea(merge(bounds(child),b));
+            const float cost = inheritanceCost + (isLeaf(child) ? childArea : childArea-halfArea(bounds(child)));
+            if (cost < bestCost) { bestCost = cost; bestChild = child; }
+          }
+          if (bestChild == INVALID) break;
+          i = bestChild;
+        }
+        return i;
+      }
+
+      /* swaps a child with a grandchild of the node if this reduces the surface area of the other child */
+      void rotate(unsigned int i)
+      {
+        const unsigned int offset = node(i).offset, N = node(i).count;
+        float bestGain = 0.0f;
+        unsigned int bestChild = INVALID, bestGrandChild = INVALID, bestParent = INVALID;
+        for (unsigned int k=0; k<N; k++)
+        {
+          const unsigned int c = offset+k;
+          if (isLeaf(c)) continue;
+          const unsigned int coffset = node(c).offset, cN = node(c).count;
+          const float area = halfArea(bounds(c));
+          for (unsigned int j=0; j<cN; j++)
+          {
+            BBox3fa rest = empty;
+            for (unsigned int l=0; l<cN; l++)
+              if (l != j) rest.extend(bounds(coffset+l));
+
+            for (unsigned int m=0; m<N; m++)
+            {
+              if (m == k) continue;
+              const float gain = area-halfArea(merge(rest,bounds(offset+m)));
+              if (gain > bestGain) {
+                bestGain = gain; bestChild = offset+m; bestGrandChild = coffset+j; bestParent = c;
+              }
+            }
+          }
+        }
+        if (bestChild == INVALID)
+          return;
+
+        swapNodes(bestChild,bestGrandChild);
+        BBox3fa b = empty;
+        for (unsigned int l=0; l<node(bestParent).count; l++)
+          b.extend(bounds(node(bestParent).offset+l));
+        setBounds(bestParent,b);
+      }
+
+      /* recalculates the bounds of a node and its ancestors, and rotates the children of inner nodes */
+      void refit(unsigned int i)
+      {
+        for (unsigned int depth=0; ; depth++)
+        {
+          const BBox3fa oldBounds = bounds(i);
+          BBox3fa b = empty;
+          if (isLeaf(i)) {
+            for (size_t j=0; j<numItems(i); j++) b.extend(primBounds(prims[node(i).offset+j]));
+          } else {
+            rotate(i);
+            for (size_t j=0; j<node(i).count; j++) b.extend(bounds(node(i).offset+j));
+          }
+          setBounds(i,b);
+          if (i == 0 || (depth > 0 && b == oldBounds)) break;
+          i = parents[i];
+        }
+      }
+
+      void insert(const RTCBuildPrimitive& prim)
+      {
+        const unsigned int slot = allocPrimitive();
+        prims[slot] = prim;
+        if (validPrimSlots) primSlots[primKey(prim)] = slot;
+        const BBox3fa b = primBounds(prim);
+
+        /* the primitive becomes the root of an empty BVH */
+        if (isLeaf(0) && numItems(0) == 0)
+        {
+          node(0).offset = slot;
+          node(0).count = 1 | RTC_FLAT_BVH_LEAF_FLAG;
+          setBounds(0,b);
+          primLeaves[slot] = 0;
+          return;
+        }
+
+        /* the sibling gets replaced by an inner node with the sibling and the new leaf as children */
+        const unsigned int sibling = findSibling(b);
+        const unsigned int pair = allocNodePair();
+        moveNode(sibling,pair);
+        node(pair+1).offset = slot;
+        node(pair+1).count = 1 | RTC_FLAT_BVH_LEAF_FLAG;
+        setBounds(pair+1,b);
+        primLeaves[slot] = pair+1;
+        node(sibling).offset = pair;
+        node(sibling).count = 2;
+        parents[pair] = parents[pair+1] = sibling;
+        refit(sibling);
+      }
+
+      void removeNode(unsigned int i)
+      {
+        if (i == 0)
+        {
+          node(0).offset = 0;
+          node(0).count = RTC_FLAT_BVH_LEAF_FLAG;
+          setBounds(0,empty);
+          return;
+        }
+
+        const unsigned int parent = parents[i];
+        const unsigned int offset = node(parent).offset, N = node(parent).count;
+        if (N > 2)
+        {
+          /* the last child fills the gap, its old node stays unused until the next rebuild */
+          if (i != offset+N-1) moveNode(offset+N-1,i);
+          node(parent).count--;
+        }
+        else
+        {
+          /* the sibling replaces the parent */
+          moveNode(i == offset ? offset+1 : offset,parent);
+          freeNodePairs.push_back(offset);
+        }
+        refit(parent);
+      }
+
+      void remove(const RTCBuildPrimitive& prim)
+      {
+        if (!validPrimSlots) initPrimSlots();
+        auto it = primSlots.find(primKey(prim));
+        if (it == primSlots.end())
+          throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"primitive not found in BVH");
+        const unsigned int slot = it->second;
+        primSlots.erase(it);
+
+        /* the last primitive of the leaf fills the gap */
+        const unsigned int leaf = primLeaves[slot];
+        const unsigned int last = node(leaf).offset+numItems(leaf)-1;
+        if (slot != last) {
+          prims[slot] = prims[last];
+          primSlots[primKey(prims[slot])] = slot;
+        }
+        primLeaves[last] = INVALID;
+        freePrims.push_back(last);
+
+        node(leaf).count--;
+        if (numItems(leaf)) refit(leaf);
+        else removeNode(leaf);
+      }
+
+      void insert(const RTCBuildPrimitive* prims, size_t N)
+      {
+        for (size_t i=0; i<N; i++) insert(prims[i]);
+        numUpdates += N;
+        rebuildIfDegraded();
+      }
+
+      void remove(const RTCBuildPrimitive* prims, size_t N)
+      {
+        for (size_t i=0; i<N; i++) remove(prims[i]);
+        numUpdates += N;
+        rebuildIfDegraded();
+      }
+
+    public:
+      BVH* bvh;
+      RTCBuildArguments arguments;                  //!< settings for rebuilds
+      mvector<RTCBuildPrimitive> prims;             //!< primitives referenced by the leaves
+      std::vector<unsigned int> parents;            //!< parent of each node
+      std::vector<unsigned int> primLeaves;         //!< leaf of each primitive, or INVALID for unused slots
+      std::vector<unsigned int> freeNodePairs;      //!< first node of each unused pair of nodes
+      std::vector<unsigned int> freePrims;          //!< unused primitive slots
+      std::unordered_map<uint64_t,unsigned int> primSlots; //!< primitive slot for each geomID and primID
+      size_t numUpdates;                            //!< number of inserted and removed primitives since the last build
+      bool validPrimSlots;                          //!< primSlots gets built by the first removal
+    };
+
+    BVH::~BVH() {
+      device->refDec();
     }
   }
 }
@@ -352,17 +1093,38 @@ RTC_NAMESPACE_BEGIN
       return nullptr;
     }
 
-    RTC_API void* rtcBuildBVH(const RTCBuildArguments* arguments)
+    RTC_API void* rtcBuildBVH(const RTCBuildArguments* args)
     {
-      BVH* bvh = (BVH*) arguments->bvh;
+      BVH* bvh = (BVH*) args->bvh;
       RTC_CATCH_BEGIN;
       RTC_TRACE(rtcBuildBVH);
       RTC_VERIFY_HANDLE(bvh);
-      RTC_VERIFY_HANDLE(arguments);
-      RTC_VERIFY_HANDLE(arguments->createNode);
-      RTC_VERIFY_HANDLE(arguments->setNodeChildren);
-      RTC_VERIFY_HANDLE(arguments->setNodeBounds);
-      RTC_VERIFY_HANDLE(arguments->createLeaf);
+      RTC_VERIFY_HANDLE(args);
+
+      /* arguments of older applications may lack the members at the end of the structure */
+      RTCBuildArguments defaultArguments = rtcDefaultBuildArguments();
+      memcpy((void*)&defaultArguments,(const void*)args,min(sizeof(RTCBuildArguments),args->byteSize));
+      const RTCBuildArguments* arguments = &defaultArguments;
+
+      const bool flat = arguments->buildFlags & RTC_BUILD_FLAG_FLAT_NODES;
+      const bool incremental = arguments->buildFlags & RTC_BUILD_FLAG_INCREMENTAL;
+      const bool mblur = arguments->timeSegmentCount > 0;
+      if (!flat) {
+        RTC_VERIFY_HANDLE(arguments->createNode);
+        RTC_VERIFY_HANDLE(arguments->setNodeChildren);
+        RTC_VERIFY_HANDLE(arguments->createLeaf);
+        if (mblur) {
+          RTC_VERIFY_HANDLE(arguments->setNodeLinearBounds);
+          RTC_VERIFY_HANDLE(arguments->primitiveLinearBounds);
+        } else {
+          RTC_VERIFY_HANDLE(arguments->setNodeBounds);
+        }
+      }
+      else if (mblur)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"motion blur is not supported for flat BVH nodes");
+
+      if (incremental && !flat)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"incremental updates require flat BVH nodes");
 
       if (arguments->primitiveArrayCapacity < arguments->primitiveCount)
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"primitiveArrayCapacity must be greater or equal to primitiveCount")
@@ -370,32 +1132,100 @@ RTC_NAMESPACE_BEGIN
       /* initialize the allocator */
       bvh->allocator.init_estimate(arguments->primitiveCount*sizeof(BBox3fa));
       bvh->allocator.reset();
+      bvh->numFlatNodes = 0;
+      bvh->updater.reset();
 
-      /* switch between different builders based on quality level */
-      if (arguments->buildQuality == RTC_BUILD_QUALITY_LOW)
-        return rtcBuildBVHMorton(arguments);
-      else if (arguments->buildQuality == RTC_BUILD_QUALITY_MEDIUM)
-        return rtcBuildBVHBinnedSAH(arguments);
-      else if (arguments->buildQuality == RTC_BUILD_QUALITY_HIGH) {
-        if (arguments->splitPrimitive == nullptr || arguments->primitiveArrayCapacity <= arguments->primitiveCount)
-          return rtcBuildBVHBinnedSAH(arguments);
-        else
-          return rtcBuildBVHSpatialSAH(arguments);
+      void* root = nullptr;
+      if (incremental)
+      {
+        /* build over a copy of the primitives, which the updater owns */
+        bvh->updater.reset(new FlatBVHUpdater(bvh,arguments));
+        bvh->updater->prims.resize(arguments->primitiveCount);
+        if (arguments->primitiveCount)
+          memcpy((void*)bvh->updater->prims.data(),(const void*)arguments->primitives,arguments->primitiveCount*sizeof(RTCBuildPrimitive));
+        bvh->updater->build();
+        root = bvh->flat_nodes.data();
+      }
+      else if (mblur)
+        root = rtcBuildBVHMSMBlur(arguments);
+      else if (flat) {
+        FlatOutput output(bvh,arguments->primitiveArrayCapacity);
+        root = rtcBuildBVH(arguments,output);
+      } else {
+        CallbackOutput output(arguments);
+        root = rtcBuildBVH(arguments,output);
       }
-      else
-        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid build quality");
 
       /* if we are in dynamic mode, then do not clear temporary data */
       if (!(arguments->buildFlags & RTC_BUILD_FLAG_DYNAMIC))
-      {
-        bvh->morton_src.clear();
-        bvh->morton_tmp.clear();
-      }
+        bvh->clearTemporaryData();
+      return root;
+
+      RTC_CATCH_END(bvh->device);
+      return nullptr;
+    }
 
+    RTC_API size_t rtcGetBVHNodeCount(RTCBVH hbvh)
+    {
+      BVH* bvh = (BVH*) hbvh;
+      RTC_CATCH_BEGIN;
+      RTC_TRACE(rtcGetBVHNodeCount);
+      RTC_VERIFY_HANDLE(hbvh);
+      return bvh->numFlatNodes;
+      RTC_CATCH_END(bvh->device);
+      return 0;
+    }
+
+    RTC_API const RTCFlatBVHNode* rtcGetBVHNodes(RTCBVH hbvh)
+    {
+      BVH* bvh = (BVH*) hbvh;
+      RTC_CATCH_BEGIN;
+      RTC_TRACE(rtcGetBVHNodes);
+      RTC_VERIFY_HANDLE(hbvh);
+      return bvh->numFlatNodes ? bvh->flat_nodes.data() : nullptr;
       RTC_CATCH_END(bvh->device);
       return nullptr;
     }
 
+    RTC_API const RTCBuildPrimitive* rtcGetBVHPrimitives(RTCBVH hbvh)
+    {
+      BVH* bvh = (BVH*) hbvh;
+      RTC_CATCH_BEGIN;
+      RTC_TRACE(rtcGetBVHPrimitives);
+      RTC_VERIFY_HANDLE(hbvh);
+      if (!bvh->updater)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"BVH not built with RTC_BUILD_FLAG_INCREMENTAL");
+      return bvh->updater->prims.data();
+      RTC_CATCH_END(bvh->device);
+      return nullptr;
+    }
+
+    RTC_API void rtcInsertBVHPrimitives(RTCBVH hbvh, const RTCBuildPrimitive* primitives, size_t primitiveCount)
+    {
+      BVH* bvh = (BVH*) hbvh;
+      RTC_CATCH_BEGIN;
+      RTC_TRACE(rtcInsertBVHPrimitives);
+      RTC_VERIFY_HANDLE(hbvh);
+      if (!bvh->updater)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"BVH not built with RTC_BUILD_FLAG_INCREMENTAL");
+      if (primitiveCount) RTC_VERIFY_HANDLE(primitives);
+      bvh->updater->insert(primitives,primitiveCount);
+      RTC_CATCH_END(bvh->device);
+    }
+
+    RTC_API void rtcRemoveBVHPrimitives(RTCBVH hbvh, const RTCBuildPrimitive* primitives, size_t primitiveCount)
+    {
+      BVH* bvh = (BVH*) hbvh;
+      RTC_CATCH_BEGIN;
+      RTC_TRACE(rtcRemoveBVHPrimitives);
+      RTC_VERIFY_HANDLE(hbvh);
+      if (!bvh->updater)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"BVH not built with RTC_BUILD_FLAG_INCREMENTAL");
+      if (primitiveCount) RTC_VERIFY_HANDLE(primitives);
+      bvh->updater->remove(primitives,primitiveCount);
+      RTC_CATCH_END(bvh->device);
+    }
+
     RTC_API void* rtcThreadLocalAlloc(RTCThreadLocalAllocator localAllocator, size_t bytes, size_t align)
     {
       FastAllocator::CachedAllocator* alloc = (FastAllocator::CachedAllocator*) localAllocator;
@@ -412,8 +1242,7 @@ RTC_NAMESPACE_BEGIN
       RTC_CATCH_BEGIN;
       RTC_TRACE(rtcStaticBVH);
       RTC_VERIFY_HANDLE(hbvh);
-      bvh->morton_src.clear();
-      bvh->morton_tmp.clear();
+      bvh->clearTemporaryData();
       RTC_CATCH_END(bvh->device);
     }
 
@@ -65,10 +65,15 @@ namespace embree
       quality_flags = (RTCBuildQuality) device->quality_flags;
     if (device->scene_flags != -1)
       scene_flags = (RTCSceneFlags) device->scene_flags;
+
+    if (device->traversal_statistics)
+      traversalStats.reset(new TraversalStatistics(device->traversal_statistics));
   }
 
   Scene::~Scene() noexcept
   {
+    if (traversalStats && device->verbosity(2))
+      traversalStats->print();
     device->refDec();
   }
   
@@ -800,7 +805,14 @@ namespace embree
   {
     checkIfModifiedAndSet();
     if (!isModified()) return;
-    
+
+    /* gather per phase timings and counters of this commit */
+    CommitStatistics* stats = getCommitStatistics();
+    double t0 = 0.0;
+    if (stats) {
+      stats->reset();
+      t0 = getSeconds();
+    }
 
     /* print scene statistics */
     if (device->verbosity(2))
@@ -854,6 +866,16 @@ namespace embree
         }
       });
 
+    if (stats)
+    {
+      stats->add(RTC_BUILD_PHASE_COMMIT,getSeconds()-t0,numPrimitives());
+      if (device->verbosity(2))
+        stats->print();
+    }
+
+    if (traversalStats)
+      traversalStats->resize(geometries.size());
+
     setModified(false);
   }
 
@@ -868,6 +890,32 @@ namespace embree
     return quality_flags;
   }
 
+  void Scene::setRayDistribution(const RTCRay* rays, size_t numRays, float weight)
+  {
+    /* store rays in blocks of 4 and pad with rays that never hit anything */
+    const size_t numBlocks = (numRays+3)/4;
+    rayDistribution.rays.resize(32*numBlocks);
+    for (size_t i=0; i<4*numBlocks; i++)
+    {
+      float* ray = rayDistribution.rays.data() + 32*(i/4) + (i%4);
+      if (i >= numRays) {
+        for (size_t k=0; k<6; k++) ray[4*k] = 0.0f;
+        ray[24] = pos_inf; ray[28] = neg_inf;
+        continue;
+      }
+      const Vec3fa org(rays[i].org_x,rays[i].org_y,rays[i].org_z);
+      const Vec3fa dir(rays[i].dir_x,rays[i].dir_y,rays[i].dir_z);
+      const Vec3fa rdir = rcp_safe(dir);
+      ray[ 0] = org.x;  ray[ 4] = org.y;  ray[ 8] = org.z;
+      ray[12] = rdir.x; ray[16] = rdir.y; ray[20] = rdir.z;
+      ray[24] = max(0.0f,rays[i].tnear);
+      ray[28] = rays[i].tfar;
+    }
+    rayDistribution.numRays = numRays;
+    rayDistribution.weight = clamp(weight,0.0f,1.0f);
+    setModified();
+  }
+
   void Scene::setSceneFlags(RTCSceneFlags scene_flags_i)
   {
     if (scene_flags == scene_flags_i) return;
@@ -892,7 +940,8 @@ namespace embree
       scheduler = taskGroup->scheduler;
       if (scheduler == null) {
         buildLock.lock();
-        taskGroup->scheduler = scheduler = new TaskScheduler;
+        const TaskScheduler::Priority priority = (scene_flags & RTC_SCENE_FLAG_BACKGROUND_BUILD) ? TaskScheduler::PRIORITY_BACKGROUND : TaskScheduler::PRIORITY_INTERACTIVE;
+        taskGroup->scheduler = scheduler = new TaskScheduler(priority);
       }
     }
 
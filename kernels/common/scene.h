@@ -5,6 +5,7 @@
 
 #include "default.h"
 #include "device.h"
+#include "stat.h"
 #include "builder.h"
 #include "scene_triangle_mesh.h"
 #include "scene_quad_mesh.h"
@@ -17,6 +18,7 @@
 #include "scene_grid_mesh.h"
 #include "scene_points.h"
 #include "../subdiv/tessellation_cache.h"
+#include "../builders/heuristic_ray_distribution.h"
 
 #include "acceln.h"
 #include "geometry.h"
@@ -186,6 +188,8 @@ namespace embree
     void setSceneFlags(RTCSceneFlags scene_flags);
     RTCSceneFlags getSceneFlags() const;
 
+    void setRayDistribution(const RTCRay* rays, size_t numRays, float weight);
+
     void build_cpu_accels();
     void build_gpu_accels();
     void commit (bool join);
@@ -254,10 +258,21 @@ namespace embree
       return geometries[i]; 
     }
 
+    /*! returns the statistics to gather during commit, or nullptr when disabled */
+    __forceinline CommitStatistics* getCommitStatistics() {
+      return device->commit_statistics ? &commitStats : nullptr;
+    }
+
+    /*! returns the statistics to gather during traversal, or nullptr when disabled */
+    __forceinline TraversalStatistics* getTraversalStatistics() {
+      return traversalStats.get();
+    }
+
     /* flag decoding */
     __forceinline bool isFastAccel() const { return !isCompactAccel() && !isRobustAccel(); }
     __forceinline bool isCompactAccel() const { return scene_flags & RTC_SCENE_FLAG_COMPACT; }
-    __forceinline bool isRobustAccel()  const { return scene_flags & RTC_SCENE_FLAG_ROBUST; }
+    __forceinline bool isRobustAccel()  const { return scene_flags & (RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_WATERTIGHT); }
+    __forceinline bool isWatertightAccel() const { return scene_flags & RTC_SCENE_FLAG_WATERTIGHT; }
     __forceinline bool isStaticAccel()  const { return !(scene_flags & RTC_SCENE_FLAG_DYNAMIC); }
     __forceinline bool isDynamicAccel() const { return scene_flags & RTC_SCENE_FLAG_DYNAMIC; }
     
@@ -291,6 +306,9 @@ namespace embree
     
     RTCSceneFlags scene_flags;
     RTCBuildQuality quality_flags;
+    RayDistribution rayDistribution; //!< sampled ray distribution to guide BVH builds
+    CommitStatistics commitStats;    //!< per phase timings and counters of the last commit
+    std::unique_ptr<TraversalStatistics> traversalStats; //!< sampled traversal statistics
     MutexSys buildMutex;
     MutexSys geometriesMutex;
 
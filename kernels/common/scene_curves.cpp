@@ -367,6 +367,11 @@ namespace embree
     if (getCurveBasis() == GTY_BASIS_HERMITE)
       tangents0 = tangents[0];
 
+    /* static round curves can get subdivided into sub-segments for building */
+    subSegments = device->hair_subdivision_angle > 0.0f &&
+      getCurveType() == GTY_SUBTYPE_ROUND_CURVE && getCurveBasis() != GTY_BASIS_HERMITE &&
+      numTimeSteps == 1 && size() < (size_t(1) << SUBSEGMENT_PRIMID_BITS);
+
     Geometry::commit();
   }
 
@@ -406,15 +411,55 @@ namespace embree
       CurveGeometryISA (Device* device, Geometry::GType gtype)
         : CurveInterfaceT<Curve>(device,gtype) {}
 
-      LinearSpace3fa computeAlignedSpace(const size_t primID) const
+      /*! returns the part of the curve covered by the sub-segment as bezier curve */
+      static __forceinline BezierCurveT<Vec3ff> subCurve(const Curve3ff& curve, const BBox1f& u)
+      {
+        const float s = (1.0f/3.0f)*(u.upper-u.lower);
+        const Vec3ff p0 = curve.eval(u.lower);
+        const Vec3ff p3 = curve.eval(u.upper);
+        return BezierCurveT<Vec3ff>(p0,madd(Vec3ff(s),curve.eval_du(u.lower),p0),nmadd(Vec3ff(s),curve.eval_du(u.upper),p3),p3);
+      }
+
+      /*! calculates bounds of the round curve restricted to the sub-segment */
+      __forceinline BBox3fa accurateRoundBounds(const Curve3ff& curve, size_t segment) const
+      {
+        if (likely(!this->isSubSegment(unsigned(segment))))
+          return curve.accurateRoundBounds();
+        return subCurve(curve,this->subSegmentRange(unsigned(segment))).accurateRoundBounds();
+      }
+
+      unsigned int subSegmentLevel(size_t primID, float maxAngle) const
+      {
+        if (!this->subSegments)
+          return 0;
+
+        /* estimate how much the curve turns by summing the angles between sampled tangents */
+        const Curve3ff curve = getCurveScaledRadius(primID);
+        const int N = 8;
+        float angle = 0.0f;
+        Vec3fa t0 = normalize_safe(Vec3fa(curve.eval_du(0.0f)));
+        for (int i=1; i<=N; i++) {
+          const Vec3fa t1 = normalize_safe(Vec3fa(curve.eval_du(float(i)/float(N))));
+          angle += acos(clamp(dot(t0,t1),-1.0f,1.0f));
+          t0 = t1;
+        }
+
+        unsigned int level = 0;
+        while (level < CurveGeometry::MAX_SUBSEGMENT_LEVEL && angle > maxAngle*float(1 << level))
+          level++;
+        return level;
+      }
+
+      LinearSpace3fa computeAlignedSpace(const size_t segment) const
       {
         Vec3fa axisz(0,0,1);
         Vec3fa axisy(0,1,0);
         
-        const Curve3ff curve = getCurveScaledRadius(primID);
-        const Vec3fa p0 = curve.begin();
-        const Vec3fa p3 = curve.end();
-        const Vec3fa d0 = curve.eval_du(0.0f);
+        const BBox1f u = this->subSegmentRange(unsigned(segment));
+        const Curve3ff curve = getCurveScaledRadius(this->segmentPrimID(unsigned(segment)));
+        const Vec3fa p0 = curve.eval(u.lower);
+        const Vec3fa p3 = curve.eval(u.upper);
+        const Vec3fa d0 = curve.eval_du(u.lower);
         //const Vec3fa d1 = curve.eval_du(1.0f);
         const Vec3fa axisz_ = normalize(p3 - p0);
         const Vec3fa axisy_ = cross(axisz_,d0);
@@ -460,11 +505,12 @@ namespace embree
         return frame(axisz);
       }
       
-      Vec3fa computeDirection(unsigned int primID) const
+      Vec3fa computeDirection(unsigned int segment) const
       {
-        const Curve3ff c = getCurveScaledRadius(primID);
-        const Vec3fa p0 = c.begin();
-        const Vec3fa p3 = c.end();
+        const BBox1f u = this->subSegmentRange(segment);
+        const Curve3ff c = getCurveScaledRadius(this->segmentPrimID(segment));
+        const Vec3fa p0 = c.eval(u.lower);
+        const Vec3fa p3 = c.eval(u.upper);
         const Vec3fa axis1 = p3 - p0;
         return axis1;
       }
@@ -483,7 +529,7 @@ namespace embree
       {
         switch (ctype) {
         case Geometry::GTY_SUBTYPE_FLAT_CURVE: return enlarge_bounds(getCurveScaledRadius(i,itime).accurateFlatBounds(tessellationRate));
-        case Geometry::GTY_SUBTYPE_ROUND_CURVE: return enlarge_bounds(getCurveScaledRadius(i,itime).accurateRoundBounds());
+        case Geometry::GTY_SUBTYPE_ROUND_CURVE: return enlarge_bounds(accurateRoundBounds(getCurveScaledRadius(this->segmentPrimID(unsigned(i)),itime),i));
         case Geometry::GTY_SUBTYPE_ORIENTED_CURVE: return enlarge_bounds(getOrientedCurveScaledRadius(i,itime).accurateBounds());
         default: return empty;
         }
@@ -494,7 +540,7 @@ namespace embree
       {
         switch (ctype) {
         case Geometry::GTY_SUBTYPE_FLAT_CURVE: return enlarge_bounds(getCurveScaledRadius(space,i,itime).accurateFlatBounds(tessellationRate));
-        case Geometry::GTY_SUBTYPE_ROUND_CURVE: return enlarge_bounds(getCurveScaledRadius(space,i,itime).accurateRoundBounds());
+        case Geometry::GTY_SUBTYPE_ROUND_CURVE: return enlarge_bounds(accurateRoundBounds(getCurveScaledRadius(space,this->segmentPrimID(unsigned(i)),itime),i));
         case Geometry::GTY_SUBTYPE_ORIENTED_CURVE: return enlarge_bounds(getOrientedCurveScaledRadius(space,i,itime).accurateBounds());
         default: return empty;
         }
@@ -505,7 +551,7 @@ namespace embree
       {
         switch (ctype) {
         case Geometry::GTY_SUBTYPE_FLAT_CURVE: return enlarge_bounds(getCurveScaledRadius(ofs,scale,r_scale0,space,i,itime).accurateFlatBounds(tessellationRate));
-        case Geometry::GTY_SUBTYPE_ROUND_CURVE: return enlarge_bounds(getCurveScaledRadius(ofs,scale,r_scale0,space,i,itime).accurateRoundBounds());
+        case Geometry::GTY_SUBTYPE_ROUND_CURVE: return enlarge_bounds(accurateRoundBounds(getCurveScaledRadius(ofs,scale,r_scale0,space,this->segmentPrimID(unsigned(i)),itime),i));
         case Geometry::GTY_SUBTYPE_ORIENTED_CURVE: return enlarge_bounds(getOrientedCurveScaledRadius(ofs,scale,space,i,itime).accurateBounds());
         default: return empty;
         }
@@ -101,6 +101,44 @@ namespace embree
       return vertices[itime][i].w;
     }
 
+    /*! Round curve segments can get subdivided into 2^level
+     *  sub-segments for building. The hair BVH leaves then store the
+     *  sub-segment index and level in the upper primID bits. */
+    static const unsigned int SUBSEGMENT_PRIMID_BITS = 27;
+    static const unsigned int MAX_SUBSEGMENT_LEVEL = 3;
+
+    /*! encodes the index'th of 2^level sub-segments of the primID'th curve */
+    static __forceinline unsigned int encodeSubSegment(unsigned int primID, unsigned int level, unsigned int index) {
+      return primID | (index << SUBSEGMENT_PRIMID_BITS) | (level << (SUBSEGMENT_PRIMID_BITS+3));
+    }
+
+    /*! returns the primID of a potentially encoded sub-segment */
+    __forceinline unsigned int segmentPrimID(unsigned int segment) const {
+      return subSegments ? segment & ((1u << SUBSEGMENT_PRIMID_BITS)-1) : segment;
+    }
+
+    /*! checks if the segment only covers part of the curve */
+    __forceinline bool isSubSegment(unsigned int segment) const {
+      return subSegments && (segment >> SUBSEGMENT_PRIMID_BITS) != 0;
+    }
+
+    /*! returns the curve parameter range of a potentially encoded sub-segment */
+    __forceinline BBox1f subSegmentRange(unsigned int segment) const
+    {
+      if (likely(!isSubSegment(segment))) return BBox1f(0.0f,1.0f);
+      const unsigned int level = segment >> (SUBSEGMENT_PRIMID_BITS+3);
+      const unsigned int index = (segment >> SUBSEGMENT_PRIMID_BITS) & 7;
+      const float scale = 1.0f/float(1 << level);
+      return BBox1f(float(index)*scale,float(index+1)*scale);
+    }
+
+    /*! returns into how many levels of sub-segments the i'th curve
+     *  should get subdivided for the curve to turn at most by
+     *  maxAngle in each sub-segment */
+    virtual unsigned int subSegmentLevel(size_t i, float maxAngle) const {
+      return 0;
+    }
+
     /*! gathers the curve starting with i'th vertex */
     __forceinline void gather(Vec3ff& p0, Vec3ff& p1, Vec3ff& p2, Vec3ff& p3, size_t i) const
     {
@@ -409,6 +447,7 @@ namespace embree
     Device::vector<BufferView<char>> vertexAttribs = device; //!< user buffers
     int tessellationRate;                   //!< tessellation rate for flat curve
     float maxRadiusScale = 1.0;             //!< maximal min-width scaling of curve radii
+    bool subSegments = false;               //!< primIDs in the BVH may encode sub-segments
   };
 
   namespace isa
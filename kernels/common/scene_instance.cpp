@@ -4,6 +4,7 @@
 #include "scene_instance.h"
 #include "scene.h"
 #include "motion_derivative.h"
+#include "../geometry/trianglev.h"
 namespace embree
 {
 #if defined(EMBREE_LOWEST_ISA)
@@ -12,6 +13,10 @@ namespace embree
     : Geometry(device,Geometry::GTY_INSTANCE_CHEAP,1,numTimeSteps)
     , object(object)
     , local2world(nullptr)
+    , unrolled(nullptr)
+    , numUnrolled(0)
+    , unrolledRobust(false)
+    , objectBoundsTest(false)
   {
     if (object) object->refInc();
     gsubtype = GTY_SUBTYPE_INSTANCE_LINEAR;
@@ -25,6 +30,7 @@ namespace embree
 
   Instance::~Instance()
   {
+    clearUnrolled();
     device->free(local2world);
     device->memoryMonitor(-ssize_t(numTimeSteps*sizeof(AffineSpace3ff)), true);
     if (object) object->refDec();
@@ -62,7 +68,6 @@ namespace embree
     Geometry::update();
   }
 
-#if 0
   void Instance::preCommit()
   {
 #if 0 // disable expensive instance optimization for now
@@ -77,8 +82,80 @@ namespace embree
 #endif
 
     Geometry::preCommit();
+    objectBoundsTest = device->instance_object_bounds_test;
+    unroll();
+  }
+
+  void Instance::unroll()
+  {
+    clearUnrolled();
+
+    const size_t threshold = device->instance_unroll_threshold;
+    if (threshold == 0 || numTimeSteps != 1 || object == nullptr)
+      return;
+
+    /* only small scenes of static triangle meshes without filter functions get unrolled */
+    Scene* scene = (Scene*) object;
+    size_t numTriangles = 0;
+    for (size_t geomID=0; geomID<scene->size(); geomID++)
+    {
+      Geometry* geom = scene->get(geomID);
+      if (geom == nullptr || !geom->isEnabled()) continue;
+      if (geom->getType() != GTY_TRIANGLE_MESH || geom->numTimeSteps != 1) return;
+      if (geom->hasGeometryFilterFunctions() || geom->hasArgumentFilterFunctions()) return;
+      numTriangles += geom->size();
+      if (numTriangles > threshold) return;
+    }
+    if (numTriangles == 0) return;
+
+    /* transform all triangles into world space and store them in blocks of 4 */
+    const size_t numBlocks = Triangle4v::blocks(numTriangles);
+    device->memoryMonitor(numBlocks*sizeof(Triangle4v), false);
+    Triangle4v* tris = (Triangle4v*) device->malloc(numBlocks*sizeof(Triangle4v),16);
+    for (size_t i=0; i<numBlocks; i++)
+      new (&tris[i]) Triangle4v(Vec3vf4(zero),Vec3vf4(zero),Vec3vf4(zero),vuint4(-1),vuint4(-1));
+
+    const AffineSpace3fa xfm = getLocal2World();
+    BBox3fa bounds = empty;
+    size_t n = 0;
+    for (size_t geomID=0; geomID<scene->size(); geomID++)
+    {
+      TriangleMesh* mesh = scene->getSafe<TriangleMesh>(geomID);
+      if (mesh == nullptr || !mesh->isEnabled()) continue;
+      for (size_t primID=0; primID<mesh->size(); primID++)
+      {
+        if (!mesh->valid(primID,0)) continue;
+        const TriangleMesh::Triangle& tri = mesh->triangle(primID);
+        const Vec3fa v0 = xfmPoint(xfm,mesh->vertex(tri.v[0]));
+        const Vec3fa v1 = xfmPoint(xfm,mesh->vertex(tri.v[1]));
+        const Vec3fa v2 = xfmPoint(xfm,mesh->vertex(tri.v[2]));
+        Triangle4v& block = tris[n/4];
+        const size_t k = n%4;
+        block.v0.x[k] = v0.x; block.v0.y[k] = v0.y; block.v0.z[k] = v0.z;
+        block.v1.x[k] = v1.x; block.v1.y[k] = v1.y; block.v1.z[k] = v1.z;
+        block.v2.x[k] = v2.x; block.v2.y[k] = v2.y; block.v2.z[k] = v2.z;
+        block.geomID()[k] = unsigned(geomID);
+        block.primID()[k] = unsigned(primID);
+        bounds.extend(v0); bounds.extend(v1); bounds.extend(v2);
+        n++;
+      }
+    }
+
+    unrolled = tris;
+    numUnrolled = numBlocks;
+    unrolledBounds = bounds;
+    unrolledNormalXfm = xfm.l.transposed()/xfm.l.det();
+    unrolledRobust = scene->isRobustAccel();
+  }
+
+  void Instance::clearUnrolled()
+  {
+    if (unrolled == nullptr) return;
+    device->free(unrolled);
+    device->memoryMonitor(-ssize_t(numUnrolled*sizeof(Triangle4v)), true);
+    unrolled = nullptr;
+    numUnrolled = 0;
   }
-#endif
 
   void Instance::addElementsToCount (GeometryCounts & counts) const 
   {
@@ -9,6 +9,8 @@
 namespace embree
 {
   struct MotionDerivativeCoefficients;
+  template<int M> struct TriangleMv;
+  typedef TriangleMv<4> Triangle4v;
 
   /*! Instanced acceleration structure */
   struct Instance : public Geometry
@@ -55,12 +57,30 @@ namespace embree
     virtual void build() {}
     virtual void addElementsToCount (GeometryCounts & counts) const override;
     virtual void commit() override;
+    virtual void preCommit() override;
+
+  private:
+
+    /*! bakes the transformed triangles of small instanced scenes */
+    void unroll();
+
+    /*! frees the unrolled triangles again */
+    void clearUnrolled();
+
+  public:
+
+    /*! returns true if the instanced triangles got unrolled into world space */
+    __forceinline bool isUnrolled() const {
+      return numUnrolled != 0;
+    }
 
   public:
 
      /*! calculates the bounds of instance */
     __forceinline BBox3fa bounds(size_t i) const {
       assert(i == 0);
+      if (unlikely(isUnrolled()))
+        return unrolledBounds;
       if (unlikely(gsubtype == GTY_SUBTYPE_INSTANCE_QUATERNION))
         return xfmBounds(quaternionDecompositionToAffineSpace(local2world[0]),object->bounds.bounds());
       return xfmBounds(local2world[0],object->bounds.bounds());
@@ -74,6 +94,8 @@ namespace embree
      /*! calculates the bounds of instance */
     __forceinline BBox3fa bounds(size_t i, size_t itime) const {
       assert(i == 0);
+      if (unlikely(isUnrolled()))
+        return unrolledBounds;
       if (unlikely(gsubtype == GTY_SUBTYPE_INSTANCE_QUATERNION))
         return xfmBounds(quaternionDecompositionToAffineSpace(local2world[itime]),getObjectBounds(itime));
       return xfmBounds(local2world[itime],getObjectBounds(itime));
@@ -221,6 +243,13 @@ namespace embree
     Accel* object;                 //!< pointer to instanced acceleration structure
     AffineSpace3ff* local2world;   //!< transformation from local space to world space for each timestep (either normal matrix or quaternion decomposition)
     AffineSpace3fa world2local0;   //!< transformation from world space to local space for timestep 0
+
+    Triangle4v* unrolled;          //!< world space triangles of the instanced scene, if the instance got unrolled
+    size_t numUnrolled;            //!< number of unrolled triangle blocks
+    BBox3fa unrolledBounds;        //!< world space bounds of the unrolled triangles
+    LinearSpace3fa unrolledNormalXfm; //!< transforms world space geometry normals of unrolled triangles into object space
+    bool unrolledRobust;           //!< unrolled triangles use the robust intersector
+    bool objectBoundsTest;         //!< rays get tested against the object space bounds of the instanced scene before traversing it
   };
 
   namespace isa
@@ -14,6 +14,8 @@ namespace embree
     object = nullptr;
     objects = nullptr;
     numObjects = 0;
+    world2local0 = nullptr;
+    numWorld2Local0 = 0;
     gsubtype = GTY_SUBTYPE_INSTANCE_LINEAR;
     l2w_buf.resize(numTimeSteps);
     device->memoryMonitor(sizeof(*this), false);
@@ -21,6 +23,7 @@ namespace embree
 
   InstanceArray::~InstanceArray()
   {
+    clearWorld2Local();
     if (object) object->refDec();
     if (objects) {
       for (size_t i = 0; i < numObjects; ++i) {
@@ -96,13 +99,14 @@ namespace embree
       if ((format != RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR)
        && (format != RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR)
        && (format != RTC_FORMAT_FLOAT3X4_ROW_MAJOR)
-       && (format != RTC_FORMAT_QUATERNION_DECOMPOSITION))
+       && (format != RTC_FORMAT_QUATERNION_DECOMPOSITION)
+       && (format != RTC_FORMAT_QUATERNION_TRANSLATION_SCALE_HALF))
         throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid transform buffer format");
 
       if (slot >= l2w_buf.size())
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid transform buffer slot");
 
-      if (format == RTC_FORMAT_QUATERNION_DECOMPOSITION)
+      if (format == RTC_FORMAT_QUATERNION_DECOMPOSITION || format == RTC_FORMAT_QUATERNION_TRANSLATION_SCALE_HALF)
         gsubtype = GTY_SUBTYPE_INSTANCE_QUATERNION;
       numPrimitives = num;
       l2w_buf[slot].set(buffer, offset, stride, num, format);
@@ -187,9 +191,43 @@ namespace embree
       if (object) object->refInc();
     }
 
+    updateWorld2Local();
     Geometry::commit();
   }
 
+  void InstanceArray::clearWorld2Local()
+  {
+    if (world2local0 == nullptr)
+      return;
+
+    device->free(world2local0);
+    device->memoryMonitor(-ssize_t(numWorld2Local0*sizeof(AffineSpace3fa)), true);
+    world2local0 = nullptr;
+    numWorld2Local0 = 0;
+  }
+
+  void InstanceArray::updateWorld2Local()
+  {
+    clearWorld2Local();
+    if (!device->instance_array_world2local_cache || numTimeSteps != 1 || numPrimitives == 0)
+      return;
+
+    /* compact transformations are used to save memory, thus they get decoded on the fly */
+    if (l2w_buf[0].getFormat() == RTC_FORMAT_QUATERNION_TRANSLATION_SCALE_HALF)
+      return;
+
+    /* each transformation is stored in its own cache line, which is all
+     * the intersector touches when entering an instance */
+    const size_t N = numPrimitives;
+    device->memoryMonitor(N*sizeof(AffineSpace3fa), false);
+    AffineSpace3fa* xfms = (AffineSpace3fa*) device->malloc(N*sizeof(AffineSpace3fa),64);
+    for (size_t i=0; i<N; i++)
+      xfms[i] = rcp(getLocal2World(i));
+
+    world2local0 = xfms;
+    numWorld2Local0 = N;
+  }
+
   // TODO InstanceArray: merge this with scene_array.cpp
   namespace {
 
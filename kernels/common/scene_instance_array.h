@@ -166,11 +166,15 @@ namespace embree
     }
 
     __forceinline AffineSpace3fa getWorld2Local(size_t i) const {
+      if (likely(world2local0))
+        return world2local0[i];
       return rcp(getLocal2World(i));
     }
 
     __forceinline AffineSpace3fa getWorld2Local(size_t i, float t) const {
-      return rcp(getLocal2World(i, t));
+      if (numTimeSegments() > 0)
+        return rcp(getLocal2World(i, t));
+      return getWorld2Local(i);
     }
 
     template<int K>
@@ -282,6 +286,25 @@ namespace embree
         transform.p.w    = q.r;
         return transform;
       }
+      else if (l2w_buf[itime].getFormat() == RTC_FORMAT_QUATERNION_TRANSLATION_SCALE_HALF) {
+        /* translation, uniform scale and rotation quaternion expanded to a quaternion decomposition */
+        const unsigned short* data = reinterpret_cast<const unsigned short*>(l2w_buf[itime].getPtr(i));
+        AffineSpace3ff transform(zero);
+        const float scale = half_to_float(data[3]);
+        transform.l.vx.x = scale;
+        transform.l.vy.y = scale;
+        transform.l.vz.z = scale;
+        transform.l.vx.y = half_to_float(data[0]);
+        transform.l.vx.z = half_to_float(data[1]);
+        transform.l.vy.z = half_to_float(data[2]);
+        Quaternion3f q(half_to_float(data[4]), half_to_float(data[5]), half_to_float(data[6]), half_to_float(data[7]));
+        q = normalize(q);
+        transform.l.vx.w = q.i;
+        transform.l.vy.w = q.j;
+        transform.l.vz.w = q.k;
+        transform.p.w    = q.r;
+        return transform;
+      }
       else if (l2w_buf[itime].getFormat() == RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR) {
         AffineSpace3f* l2w = reinterpret_cast<AffineSpace3f*>(l2w_buf[itime].getPtr(i));
         return AffineSpace3ff(*l2w);
@@ -302,12 +325,18 @@ namespace embree
       return l2w(i, 0);
     }
 
+    /*! (re)computes the cached world to local transformations of a static instance array */
+    void updateWorld2Local();
+    void clearWorld2Local();
+
   private:
     Accel* object;                   //!< fast path if only one scene is instanced
     Accel** objects;
     uint32_t numObjects;
     Device::vector<RawBufferView> l2w_buf = device; //!< transformation from local space to world space for each timestep (either normal matrix or quaternion decomposition)
     BufferView<uint32_t> object_ids; //!< array of scene ids per instance array primitive
+    AffineSpace3fa* world2local0;    //!< cached transformation from world space to local space of each instance, only for static instance arrays
+    size_t numWorld2Local0;          //!< number of cached transformations
   };
 
   namespace isa
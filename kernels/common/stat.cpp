@@ -125,4 +125,183 @@ namespace embree
     cout << "#user7/user3 " << 100.0f*float(cntrs.user[7])/float(cntrs.user[3]) << "%" << std::endl;
     cout << std::endl;
   }
+
+  TraversalSample::Geometry& TraversalSample::geometry(unsigned int geomID)
+  {
+    for (size_t i=0; i<numGeometries; i++)
+      if (geometries[i].geomID == geomID) return geometries[i];
+
+    /* the counts of a geometry that reappears after a flush are added as separate ray */
+    if (numGeometries == MAX_GEOMETRIES)
+      stats->flush(*this);
+
+    Geometry& g = geometries[numGeometries++];
+    g.geomID = geomID;
+    g.nodes = g.leaves = g.primitives = 0;
+    return g;
+  }
+
+  void TraversalStatistics::Counter::reset()
+  {
+    total.store(0);
+    max.store(0);
+    for (auto& h : histogram) h.store(0);
+  }
+
+  void TraversalStatistics::Counter::add(size_t count)
+  {
+    total.fetch_add(count,std::memory_order_relaxed);
+    histogram[bin(count)].fetch_add(1,std::memory_order_relaxed);
+    size_t m = max.load(std::memory_order_relaxed);
+    while (m < count && !max.compare_exchange_weak(m,count,std::memory_order_relaxed));
+  }
+
+  void TraversalStatistics::Counter::get(RTCTraversalCounter& counter) const
+  {
+    counter.total += total.load();
+    counter.max = std::max(counter.max,max.load());
+    for (size_t i=0; i<RTC_TRAVERSAL_HISTOGRAM_BINS; i++)
+      counter.histogram[i] += histogram[i].load();
+  }
+
+  void TraversalStatistics::Counters::reset()
+  {
+    numRays.store(0);
+    nodes.reset();
+    leaves.reset();
+    primitives.reset();
+  }
+
+  void TraversalStatistics::Counters::add(size_t numNodes, size_t numLeaves, size_t numPrimitives)
+  {
+    numRays.fetch_add(1,std::memory_order_relaxed);
+    nodes.add(numNodes);
+    leaves.add(numLeaves);
+    primitives.add(numPrimitives);
+  }
+
+  void TraversalStatistics::Counters::get(RTCTraversalStatistics& stats) const
+  {
+    stats.numRays += numRays.load();
+    nodes.get(stats.nodes);
+    leaves.get(stats.leaves);
+    primitives.get(stats.primitives);
+  }
+
+  TraversalStatistics::TraversalStatistics (size_t rate)
+    : rate(rate), numGeometries(0) {}
+
+  TraversalStatistics::~TraversalStatistics ()
+  {
+    for (size_t i=0; i<numGeometries; i++)
+      delete geometries[i].load();
+  }
+
+  void TraversalStatistics::reset()
+  {
+    for (auto& t : threads) t.reset();
+    for (size_t i=0; i<numGeometries; i++)
+      if (Counters* g = geometries[i].load()) g->reset();
+  }
+
+  void TraversalStatistics::resize(size_t N)
+  {
+    if (N <= numGeometries) return;
+    std::unique_ptr<std::atomic<Counters*>[]> grown(new std::atomic<Counters*>[N]);
+    for (size_t i=0; i<N; i++)
+      grown[i].store(i < numGeometries ? geometries[i].load() : nullptr);
+    geometries = std::move(grown);
+    numGeometries = N;
+  }
+
+  bool TraversalStatistics::sample() const
+  {
+    static __thread size_t counter = 0;
+    if (++counter < rate) return false;
+    counter = 0;
+    return true;
+  }
+
+  void TraversalStatistics::add(TraversalSample& sample)
+  {
+    /* threads get assigned to slots round robin on their first sample */
+    static std::atomic<size_t> nextSlot(0);
+    static __thread size_t slot = size_t(-1);
+    if (unlikely(slot == size_t(-1)))
+      slot = nextSlot++ % NUM_THREAD_SLOTS;
+
+    threads[slot].add(sample.nodes,sample.leaves,sample.primitives);
+    flush(sample);
+  }
+
+  void TraversalStatistics::flush(TraversalSample& sample)
+  {
+    for (size_t i=0; i<sample.numGeometries; i++)
+    {
+      const TraversalSample::Geometry& g = sample.geometries[i];
+      if (Counters* counters = geometry(g.geomID))
+        counters->add(g.nodes,g.leaves,g.primitives);
+    }
+    sample.numGeometries = 0;
+  }
+
+  TraversalStatistics::Counters* TraversalStatistics::geometry(unsigned int geomID)
+  {
+    /* geometries added after the last commit are not traced yet */
+    if (geomID >= numGeometries) return nullptr;
+
+    Counters* counters = geometries[geomID].load();
+    if (likely(counters)) return counters;
+
+    Counters* allocated = new Counters;
+    if (geometries[geomID].compare_exchange_strong(counters,allocated))
+      return allocated;
+    delete allocated;
+    return counters;
+  }
+
+  void TraversalStatistics::get(unsigned int geomID, RTCTraversalStatistics& stats) const
+  {
+    memset(&stats,0,sizeof(stats));
+    if (geomID == RTC_INVALID_GEOMETRY_ID) {
+      for (auto& t : threads) t.get(stats);
+    }
+    else if (geomID < numGeometries) {
+      if (const Counters* g = geometries[geomID].load()) g->get(stats);
+    }
+  }
+
+  void TraversalStatistics::print() const
+  {
+    auto printCounter = [] (const char* name, const RTCTraversalCounter& counter, size_t numRays)
+    {
+      std::cout << "    " << name << ": avg = " << float(counter.total)/float(max(numRays,size_t(1))) << ", max = " << counter.max << ", histogram =";
+      for (size_t i=0; i<RTC_TRAVERSAL_HISTOGRAM_BINS; i++)
+        std::cout << " " << counter.histogram[i];
+      std::cout << std::endl;
+    };
+
+    RTCTraversalStatistics stats;
+    get(RTC_INVALID_GEOMETRY_ID,stats);
+    std::cout << "  traversal statistics of " << stats.numRays << " sampled rays (1 in " << rate << "):" << std::endl;
+    printCounter("nodes     ",stats.nodes,stats.numRays);
+    printCounter("leaves    ",stats.leaves,stats.numRays);
+    printCounter("primitives",stats.primitives,stats.numRays);
+
+    /* list the geometries with the most primitive intersections */
+    std::vector<std::pair<size_t,unsigned int>> costs;
+    for (size_t i=0; i<numGeometries; i++) {
+      get((unsigned int)i,stats);
+      if (stats.numRays) costs.push_back(std::make_pair(stats.primitives.total,(unsigned int)i));
+    }
+    std::sort(costs.begin(),costs.end(),std::greater<std::pair<size_t,unsigned int>>());
+    for (size_t i=0; i<min(costs.size(),size_t(10)); i++)
+    {
+      get(costs[i].second,stats);
+      std::cout << "  geometry " << costs[i].second << ", " << stats.numRays << " sampled rays:" << std::endl;
+      printCounter("nodes     ",stats.nodes,stats.numRays);
+      printCounter("leaves    ",stats.leaves,stats.numRays);
+      printCounter("primitives",stats.primitives,stats.numRays);
+    }
+  }
 }
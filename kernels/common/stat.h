@@ -4,6 +4,7 @@
 #pragma once
 
 #include "default.h"
+#include "rtcore.h"
 
 /* Macros to gather statistics */
 #ifdef EMBREE_STAT_COUNTERS
@@ -113,4 +114,153 @@ namespace embree
   private:
     static Stat instance;
   };
+
+  struct TraversalStatistics;
+
+  /*! Traversal counts of a single ray, which the traversal increments
+   *  through the ray query context. For rays sampled for the traversal
+   *  statistics the counts are also tracked per geometry, where counts
+   *  of instanced scenes are attributed to the outermost instance. */
+  struct TraversalSample
+  {
+    /*! maximal number of geometries tracked per ray, further geometries flush the table */
+    static const size_t MAX_GEOMETRIES = 16;
+
+    struct Geometry
+    {
+      unsigned int geomID;
+      unsigned int nodes;
+      unsigned int leaves;
+      unsigned int primitives;
+    };
+
+    TraversalSample (TraversalStatistics* stats, const RTCRayQueryContext* user)
+      : stats(stats), attributeInstances(user->instID[0] == RTC_INVALID_GEOMETRY_ID), nodes(0), leaves(0), primitives(0), numGeometries(0) {}
+
+    /*! counts a visited inner node */
+    __forceinline void node(const RTCRayQueryContext* user)
+    {
+      nodes++;
+      if (!stats) return;
+      const unsigned int geomID = owner(user,RTC_INVALID_GEOMETRY_ID);
+      if (geomID != RTC_INVALID_GEOMETRY_ID) geometry(geomID).nodes++;
+    }
+
+    /*! counts a tested leaf, whose first primitive belongs to the given geometry */
+    __forceinline void leaf(const RTCRayQueryContext* user, unsigned int geomID)
+    {
+      leaves++;
+      if (!stats) return;
+      geomID = owner(user,geomID);
+      if (geomID != RTC_INVALID_GEOMETRY_ID) geometry(geomID).leaves++;
+    }
+
+    /*! counts an intersected primitive of the given geometry */
+    __forceinline void primitive(const RTCRayQueryContext* user, unsigned int geomID)
+    {
+      primitives++;
+      if (!stats) return;
+      geomID = owner(user,geomID);
+      if (geomID != RTC_INVALID_GEOMETRY_ID) geometry(geomID).primitives++;
+    }
+
+  private:
+
+    /*! returns the geometry of the sampled scene the counts belong to */
+    __forceinline unsigned int owner(const RTCRayQueryContext* user, unsigned int geomID) const {
+      return (attributeInstances && user->instID[0] != RTC_INVALID_GEOMETRY_ID) ? user->instID[0] : geomID;
+    }
+
+    Geometry& geometry(unsigned int geomID);
+
+  public:
+    TraversalStatistics* stats; //!< statistics the ray got sampled for, or nullptr if only its cost gets counted
+    bool attributeInstances; //!< false if the ray started inside an instance already
+    size_t nodes;
+    size_t leaves;
+    size_t primitives;
+    size_t numGeometries;
+    Geometry geometries[MAX_GEOMETRIES];
+  };
+
+  /*! Traversal statistics of a scene, gathered for one in N single
+   *  rays when the traversal_statistics=N device configuration is set.
+   *  Unlike the Stat counters this needs no special build. Each thread
+   *  adds its samples to its own slot, the slots get summed up on
+   *  demand. */
+  struct TraversalStatistics
+  {
+    ALIGNED_STRUCT_(64);
+
+    static const size_t NUM_THREAD_SLOTS = 32;
+
+    /*! distribution of a per ray count */
+    struct Counter
+    {
+      void reset();
+      void add(size_t count);
+      void get(RTCTraversalCounter& counter) const;
+
+      /*! bin 0 counts zero, bin i>0 counts the range [2^(i-1),2^i) */
+      static __forceinline size_t bin(size_t count) {
+        return count == 0 ? 0 : min(size_t(bsr(count))+1,size_t(RTC_TRAVERSAL_HISTOGRAM_BINS-1));
+      }
+
+    public:
+      std::atomic<size_t> total;
+      std::atomic<size_t> max;
+      std::atomic<size_t> histogram[RTC_TRAVERSAL_HISTOGRAM_BINS];
+    };
+
+    struct __aligned(64) Counters
+    {
+      ALIGNED_STRUCT_(64);
+
+      Counters () {
+        reset();
+      }
+
+      void reset();
+      void add(size_t nodes, size_t leaves, size_t primitives);
+      void get(RTCTraversalStatistics& stats) const;
+
+    public:
+      std::atomic<size_t> numRays;
+      Counter nodes;
+      Counter leaves;
+      Counter primitives;
+    };
+
+    TraversalStatistics (size_t rate);
+    ~TraversalStatistics ();
+
+    /*! resets all counters */
+    void reset();
+
+    /*! grows the per geometry counters to the geometries of the scene */
+    void resize(size_t numGeometries);
+
+    /*! decides per thread if the next ray gets sampled */
+    bool sample() const;
+
+    /*! adds the counts of a sampled ray */
+    void add(TraversalSample& sample);
+
+    /*! adds the per geometry counts of a sampled ray and clears them */
+    void flush(TraversalSample& sample);
+
+    /*! returns the counters of a geometry, which get allocated on first use */
+    Counters* geometry(unsigned int geomID);
+
+    /*! returns the statistics of the scene or of a geometry */
+    void get(unsigned int geomID, RTCTraversalStatistics& stats) const;
+
+    void print() const;
+
+  public:
+    size_t rate;                                          //!< one in rate rays gets sampled
+    Counters threads[NUM_THREAD_SLOTS];                   //!< per thread counters of the scene
+    size_t numGeometries;
+    std::unique_ptr<std::atomic<Counters*>[]> geometries; //!< per geometry counters, only touched geometries get allocated
+  };
 }
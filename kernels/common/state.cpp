@@ -86,6 +86,15 @@ namespace embree
 
     max_spatial_split_replications = 1.2f;
     useSpatialPreSplits = false;
+    presplit_priority = 0;
+    presplit_split_pos_weight = 1.5f;
+    presplit_max_splits_log = 5;
+    treelet_restructure_iterations = 0;
+    instance_unroll_threshold = 0;
+    instance_object_bounds_test = false;
+    instance_array_world2local_cache = true;
+    hair_subdivision_angle = 0.0f;
+    morton_code_bits = 32;
 
     max_triangles_per_leaf = inf;
 
@@ -110,6 +119,8 @@ namespace embree
     scene_flags = -1;
     verbose = 0;
     benchmark = 0;
+    commit_statistics = false;
+    traversal_statistics = 0;
 
     numThreads = 0;
     numUserThreads = 0;
@@ -408,6 +419,10 @@ namespace embree
         verbose = cin->get().Int();
       else if (tok == Token::Id("benchmark") && cin->trySymbol("="))
         benchmark = cin->get().Int();
+      else if (tok == Token::Id("commit_statistics") && cin->trySymbol("="))
+        commit_statistics = cin->get().Int();
+      else if (tok == Token::Id("traversal_statistics") && cin->trySymbol("="))
+        traversal_statistics = cin->get().Int();
       
       else if (tok == Token::Id("quality")) {
         if (cin->trySymbol("=")) {
@@ -426,6 +441,8 @@ namespace embree
             if (flag == Token::Id("dynamic") ) scene_flags |= RTC_SCENE_FLAG_DYNAMIC;
             else if (flag == Token::Id("compact")) scene_flags |= RTC_SCENE_FLAG_COMPACT;
             else if (flag == Token::Id("robust")) scene_flags |= RTC_SCENE_FLAG_ROBUST;
+            else if (flag == Token::Id("watertight")) scene_flags |= RTC_SCENE_FLAG_WATERTIGHT;
+            else if (flag == Token::Id("background")) scene_flags |= RTC_SCENE_FLAG_BACKGROUND_BUILD;
           } while (cin->trySymbol("|"));
         }
       }
@@ -438,6 +455,27 @@ namespace embree
 
       else if (tok == Token::Id("presplits") && cin->trySymbol("="))
         useSpatialPreSplits = cin->get().Int() != 0 ? true : false;
+      else if (tok == Token::Id("presplit_priority") && cin->trySymbol("=")) {
+        Token metric = cin->get();
+        if      (metric == Token::Id("area"))   presplit_priority = 0;
+        else if (metric == Token::Id("volume")) presplit_priority = 1;
+      }
+      else if (tok == Token::Id("presplit_split_pos_weight") && cin->trySymbol("="))
+        presplit_split_pos_weight = cin->get().Float();
+      else if (tok == Token::Id("presplit_max_splits_log") && cin->trySymbol("="))
+        presplit_max_splits_log = cin->get().Int();
+      else if (tok == Token::Id("treelet_restructure") && cin->trySymbol("="))
+        treelet_restructure_iterations = cin->get().Int();
+      else if (tok == Token::Id("instance_unroll_threshold") && cin->trySymbol("="))
+        instance_unroll_threshold = cin->get().Int();
+      else if (tok == Token::Id("instance_object_bounds_test") && cin->trySymbol("="))
+        instance_object_bounds_test = cin->get().Int();
+      else if (tok == Token::Id("instance_array_world2local_cache") && cin->trySymbol("="))
+        instance_array_world2local_cache = cin->get().Int();
+      else if (tok == Token::Id("hair_subdivision_angle") && cin->trySymbol("="))
+        hair_subdivision_angle = cin->get().Float();
+      else if (tok == Token::Id("morton_code_bits") && cin->trySymbol("="))
+        morton_code_bits = cin->get().Int() == 64 ? 64 : 32;
 
       else if (tok == Token::Id("tessellation_cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
@@ -482,8 +520,20 @@ namespace embree
     else std::cout << "failed" << std::endl;
 
     std::cout << "  verbosity          = " << verbose << std::endl;
+    std::cout << "  commit_statistics  = " << commit_statistics << std::endl;
+    std::cout << "  traversal_statistics = " << traversal_statistics << std::endl;
     std::cout << "  cache_size         = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  presplits          = " << useSpatialPreSplits << std::endl;
+    std::cout << "  presplit_priority  = " << (presplit_priority == 1 ? "volume" : "area") << std::endl;
+    std::cout << "  presplit_split_pos_weight = " << presplit_split_pos_weight << std::endl;
+    std::cout << "  presplit_max_splits_log   = " << presplit_max_splits_log << std::endl;
+    std::cout << "  treelet_restructure = " << treelet_restructure_iterations << std::endl;
+    std::cout << "  instance_unroll_threshold = " << instance_unroll_threshold << std::endl;
+    std::cout << "  instance_object_bounds_test = " << instance_object_bounds_test << std::endl;
+    std::cout << "  instance_array_world2local_cache = " << instance_array_world2local_cache << std::endl;
+    std::cout << "  hair_subdivision_angle = " << hair_subdivision_angle << std::endl;
+    std::cout << "  morton_code_bits   = " << morton_code_bits << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel              = " << tri_accel << std::endl;
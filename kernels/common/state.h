@@ -116,6 +116,15 @@ namespace embree
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
     bool useSpatialPreSplits;              //!< use spatial pre-splits instead of the full spatial split builder
+    int presplit_priority;                 //!< priority metric for spatial pre-splits (0 = area, 1 = volume)
+    float presplit_split_pos_weight;       //!< weight favouring pre-splits at coarse levels of the splitting grid
+    int presplit_max_splits_log;           //!< maximally 2^N sub-primitives per pre-split primitive
+    int treelet_restructure_iterations;    //!< number of treelet restructuring passes after spatial split builds (0 = disabled)
+    size_t instance_unroll_threshold;      //!< instances of triangle scenes with up to this many triangles get unrolled (0 = disabled)
+    bool instance_object_bounds_test;      //!< test rays against the object space bounds of instanced scenes before traversing them
+    bool instance_array_world2local_cache; //!< cache the inverse transformations of static instance arrays
+    float hair_subdivision_angle;          //!< round curve segments get subdivided for building until they turn less than this angle in degrees (0 = disabled)
+    int morton_code_bits;                  //!< morton code size used by the morton builders (32 or 64)
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
     size_t max_triangles_per_leaf;
 
@@ -132,6 +141,8 @@ namespace embree
     int scene_flags;
     size_t verbose;                        //!< verbosity of output
     size_t benchmark;                      //!< true
+    bool commit_statistics;                //!< gathers per phase timings and counters of each scene commit
+    size_t traversal_statistics;           //!< gathers traversal statistics of one in N single rays, 0 disables sampling
     
   public:
     size_t numThreads;                     //!< number of threads to use in builders
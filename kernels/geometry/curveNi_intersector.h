@@ -73,23 +73,24 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(normal.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = context->scene->get<CurveGeometry>(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           Vec3ff a0,a1,a2,a3; geom->gather(a0,a1,a2,a3,geom->curve(primID));
 
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
           
-          Intersector().intersect(pre,ray,context,geom,primID,a0,a1,a2,a3,Epilog(ray,context,geomID,primID));
+          Intersector().intersect(pre,ray,context,geom,segment,a0,a1,a2,a3,Epilog(ray,context,geomID,primID));
           mask &= movemask(tNear <= vfloat<M>(ray.tfar));
         }
       }
@@ -107,23 +108,24 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(shadow.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = context->scene->get<CurveGeometry>(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           Vec3ff a0,a1,a2,a3; geom->gather(a0,a1,a2,a3,geom->curve(primID));
          
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
 
-          if (Intersector().intersect(pre,ray,context,geom,primID,a0,a1,a2,a3,Epilog(ray,context,geomID,primID)))
+          if (Intersector().intersect(pre,ray,context,geom,segment,a0,a1,a2,a3,Epilog(ray,context,geomID,primID)))
             return true;
           
           mask &= movemask(tNear <= vfloat<M>(ray.tfar));
@@ -153,11 +155,11 @@ namespace embree
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
@@ -189,11 +191,11 @@ namespace embree
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
@@ -357,23 +359,24 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(normal.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = context->scene->get<CurveGeometry>(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           Vec3ff a0,a1,a2,a3; geom->gather(a0,a1,a2,a3,geom->curve(primID));
 
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
 
-          Intersector().intersect(pre,ray,k,context,geom,primID,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID));
+          Intersector().intersect(pre,ray,k,context,geom,segment,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID));
           mask &= movemask(tNear <= vfloat<M>(ray.tfar[k]));
         }
       }
@@ -391,23 +394,24 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(shadow.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = context->scene->get<CurveGeometry>(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           Vec3ff a0,a1,a2,a3; geom->gather(a0,a1,a2,a3,geom->curve(primID));
 
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
           
-          if (Intersector().intersect(pre,ray,k,context,geom,primID,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID)))
+          if (Intersector().intersect(pre,ray,k,context,geom,segment,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID)))
             return true;
           
           mask &= movemask(tNear <= vfloat<M>(ray.tfar[k]));
@@ -437,11 +441,11 @@ namespace embree
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
@@ -473,11 +477,11 @@ namespace embree
           size_t mask1 = mask;
           const size_t i1 = bscf(mask1);
           if (mask) {
-            const unsigned int primID1 = prim.primID(N)[i1];
+            const unsigned int primID1 = geom->segmentPrimID(prim.primID(N)[i1]);
             geom->prefetchL1_vertices(geom->curve(primID1));
             if (mask1) {
               const size_t i2 = bsf(mask1);
-              const unsigned int primID2 = prim.primID(N)[i2];
+              const unsigned int primID2 = geom->segmentPrimID(prim.primID(N)[i2]);
               geom->prefetchL2_vertices(geom->curve(primID2));
             }
           }
@@ -29,8 +29,9 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(normal.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = (CurveGeometry*) context->scene->get(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           const Vec3ff a0 = Vec3ff::loadu(&prim.vertices(i,N)[0]);
           const Vec3ff a1 = Vec3ff::loadu(&prim.vertices(i,N)[1]);
           const Vec3ff a2 = Vec3ff::loadu(&prim.vertices(i,N)[2]);
@@ -48,7 +49,7 @@ namespace embree
             }
           }
 
-          Intersector().intersect(pre,ray,context,geom,primID,a0,a1,a2,a3,Epilog(ray,context,geomID,primID));
+          Intersector().intersect(pre,ray,context,geom,segment,a0,a1,a2,a3,Epilog(ray,context,geomID,primID));
           mask &= movemask(tNear <= vfloat<M>(ray.tfar));
         }
       }
@@ -66,8 +67,9 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(shadow.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = (CurveGeometry*) context->scene->get(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           const Vec3ff a0 = Vec3ff::loadu(&prim.vertices(i,N)[0]);
           const Vec3ff a1 = Vec3ff::loadu(&prim.vertices(i,N)[1]);
           const Vec3ff a2 = Vec3ff::loadu(&prim.vertices(i,N)[2]);
@@ -85,7 +87,7 @@ namespace embree
             }
           }
           
-          if (Intersector().intersect(pre,ray,context,geom,primID,a0,a1,a2,a3,Epilog(ray,context,geomID,primID)))
+          if (Intersector().intersect(pre,ray,context,geom,segment,a0,a1,a2,a3,Epilog(ray,context,geomID,primID)))
             return true;
           
           mask &= movemask(tNear <= vfloat<M>(ray.tfar));
@@ -113,8 +115,9 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(normal.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = (CurveGeometry*) context->scene->get(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           const Vec3ff a0 = Vec3ff::loadu(&prim.vertices(i,N)[0]);
           const Vec3ff a1 = Vec3ff::loadu(&prim.vertices(i,N)[1]);
           const Vec3ff a2 = Vec3ff::loadu(&prim.vertices(i,N)[2]);
@@ -132,7 +135,7 @@ namespace embree
             }
           }
 
-          Intersector().intersect(pre,ray,k,context,geom,primID,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID));
+          Intersector().intersect(pre,ray,k,context,geom,segment,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID));
           mask &= movemask(tNear <= vfloat<M>(ray.tfar[k]));
         }
       }
@@ -150,8 +153,9 @@ namespace embree
           const size_t i = bscf(mask);
           STAT3(shadow.trav_prims,1,1,1);
           const unsigned int geomID = prim.geomID(N);
-          const unsigned int primID = prim.primID(N)[i];
           const CurveGeometry* geom = (CurveGeometry*) context->scene->get(geomID);
+          const unsigned int segment = prim.primID(N)[i];
+          const unsigned int primID = geom->segmentPrimID(segment);
           const Vec3ff a0 = Vec3ff::loadu(&prim.vertices(i,N)[0]);
           const Vec3ff a1 = Vec3ff::loadu(&prim.vertices(i,N)[1]);
           const Vec3ff a2 = Vec3ff::loadu(&prim.vertices(i,N)[2]);
@@ -169,7 +173,7 @@ namespace embree
             }
           }
 
-          if (Intersector().intersect(pre,ray,k,context,geom,primID,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID)))
+          if (Intersector().intersect(pre,ray,k,context,geom,segment,a0,a1,a2,a3,Epilog(ray,k,context,geomID,primID)))
             return true;
 
           mask &= movemask(tNear <= vfloat<M>(ray.tfar[k]));
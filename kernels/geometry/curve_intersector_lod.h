@@ -0,0 +1,78 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../common/ray.h"
+#include "curve_intersector_precalculations.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Selects the flat representation of a round curve when the curve
+     *  radius is smaller than the ray footprint. The footprint grows
+     *  linearly with the distance to the ray origin, scaled by the
+     *  curveLODDistanceFactor of the ray query arguments. */
+    __forceinline bool useFlatCurveLOD(const RayQueryContext* context, const Vec3fa& ray_org,
+                                       const Vec3ff& v0, const Vec3ff& v1, const Vec3ff& v2, const Vec3ff& v3)
+    {
+      const float factor = context->getCurveLODDistanceFactor();
+      if (likely(factor <= 0.0f)) return false;
+      const float r = max(v0.w,v1.w,v2.w,v3.w);
+      const float d0 = min(length(Vec3fa(v0)-ray_org),length(Vec3fa(v1)-ray_org));
+      const float d1 = min(length(Vec3fa(v2)-ray_org),length(Vec3fa(v3)-ray_org));
+      return r <= factor*min(d0,d1);
+    }
+
+    /*! epilog holding one epilog for each curve representation */
+    template<typename RoundEpilog, typename FlatEpilog>
+    struct CurveLODEpilog
+    {
+      template<typename... Args>
+      __forceinline CurveLODEpilog(Args&&... args)
+        : round(args...), flat(args...) {}
+
+      RoundEpilog round;
+      FlatEpilog flat;
+    };
+
+    /*! intersects round curves using the round intersector, or the
+     *  flat intersector if the curve is below the ray footprint, curve
+     *  sub-segments always use the round intersector */
+    template<typename RoundIntersector, typename FlatIntersector>
+    struct CurveLOD1Intersector1
+    {
+      template<typename Ray, typename Epilog>
+      __forceinline bool intersect(const CurvePrecalculations1& pre, Ray& ray,
+                                   RayQueryContext* context,
+                                   const CurveGeometry* geom, const unsigned int primID,
+                                   const Vec3ff& v0, const Vec3ff& v1, const Vec3ff& v2, const Vec3ff& v3,
+                                   const Epilog& epilog)
+      {
+        if (unlikely(!geom->isSubSegment(primID) && useFlatCurveLOD(context,ray.org,v0,v1,v2,v3)))
+          return FlatIntersector().intersect(pre,ray,context,geom,primID,v0,v1,v2,v3,epilog.flat);
+        else
+          return RoundIntersector().intersect(pre,ray,context,geom,primID,v0,v1,v2,v3,epilog.round);
+      }
+    };
+
+    template<typename RoundIntersector, typename FlatIntersector, int K>
+    struct CurveLOD1IntersectorK
+    {
+      template<typename Epilog>
+      __forceinline bool intersect(const CurvePrecalculationsK<K>& pre, RayK<K>& ray, size_t k,
+                                   RayQueryContext* context,
+                                   const CurveGeometry* geom, const unsigned int primID,
+                                   const Vec3ff& v0, const Vec3ff& v1, const Vec3ff& v2, const Vec3ff& v3,
+                                   const Epilog& epilog)
+      {
+        const Vec3fa ray_org(ray.org.x[k],ray.org.y[k],ray.org.z[k]);
+        if (unlikely(!geom->isSubSegment(primID) && useFlatCurveLOD(context,ray_org,v0,v1,v2,v3)))
+          return FlatIntersector().intersect(pre,ray,k,context,geom,primID,v0,v1,v2,v3,epilog.flat);
+        else
+          return RoundIntersector().intersect(pre,ray,k,context,geom,primID,v0,v1,v2,v3,epilog.round);
+      }
+    };
+  }
+}
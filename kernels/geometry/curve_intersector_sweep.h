@@ -56,7 +56,8 @@ namespace embree
     }
 
     template<typename NativeCurve3ff, typename Ray, typename Epilog> 
-     __forceinline bool intersect_bezier_iterative_jacobian(const Ray& ray, const float dt, const NativeCurve3ff& curve, float u, float t, const Epilog& epilog)
+     __forceinline bool intersect_bezier_iterative_jacobian(const Ray& ray, const float dt, const NativeCurve3ff& curve, float u, float t, const Epilog& epilog,
+                                                            const BBox1f& u_range = BBox1f(0.0f,1.0f))
     {
       const Vec3fa org = zero;
       const Vec3fa dir = ray.dir;
@@ -123,7 +124,7 @@ namespace embree
         {
           t+=dt;
           if (!(ray.tnear() <= t && t <= ray.tfar)) return false; // rejects NaNs
-          if (!(u >= 0.0f && u <= 1.0f)) return false; // rejects NaNs
+          if (!(u >= u_range.lower && u <= u_range.upper)) return false; // rejects NaNs
           const Vec3fa R = normalize(Q-P);
           const Vec3fa U = madd(Vec3fa(dPdu.w),R,dPdu);
           const Vec3fa V = cross(dPdu,R);
@@ -137,10 +138,11 @@ namespace embree
 #if !defined(__SYCL_DEVICE_ONLY__)
     
     template<typename NativeCurve3ff, typename Ray, typename Epilog>
-    __forceinline bool intersect_bezier_recursive_jacobian(const Ray& ray, const float dt, const NativeCurve3ff& curve, const Epilog& epilog)
+    __forceinline bool intersect_bezier_recursive_jacobian(const Ray& ray, const float dt, const NativeCurve3ff& curve, const Epilog& epilog,
+                                                           const BBox1f& u_range = BBox1f(0.0f,1.0f))
     {
-      float u0 = 0.0f;
-      float u1 = 1.0f;
+      float u0 = u_range.lower;
+      float u1 = u_range.upper;
       unsigned int depth = 1;
         
 #if defined(__AVX__)
@@ -264,7 +266,7 @@ namespace embree
         while (any(valid0))
         {
           const size_t i = select_min(valid0,tp0.lower); clear(valid0,i);
-          found = found | intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer0[i],tp0.lower[i],epilog);
+          found = found | intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer0[i],tp0.lower[i],epilog,u_range);
           //found = found | intersect_bezier_iterative_debug   (ray,dt,curve,i,u_outer0,tp0,h0,h1,Ng_outer0,dP0du,dP3du,epilog);
           valid0 &= tp0.lower+dt <= ray.tfar;
         }
@@ -277,7 +279,7 @@ namespace embree
         while (any(valid1))
         {
           const size_t i = select_min(valid1,tp1.lower); clear(valid1,i);
-          found = found | intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer1[i],tp1.upper[i],epilog);
+          found = found | intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer1[i],tp1.upper[i],epilog,u_range);
           //found = found | intersect_bezier_iterative_debug   (ray,dt,curve,i,u_outer1,tp1,h0,h1,Ng_outer1,dP0du,dP3du,epilog);
           valid1 &= tp1.lower+dt <= ray.tfar;
         }
@@ -303,7 +305,8 @@ namespace embree
 #else
     
      template<typename NativeCurve3ff, typename Ray, typename Epilog>
-     __forceinline bool intersect_bezier_recursive_jacobian(const Ray& ray, const float dt, const NativeCurve3ff& curve, const Epilog& epilog)
+     __forceinline bool intersect_bezier_recursive_jacobian(const Ray& ray, const float dt, const NativeCurve3ff& curve, const Epilog& epilog,
+                                                            const BBox1f& u_range = BBox1f(0.0f,1.0f))
     {
       const Vec3fa org = zero;
       const Vec3fa dir = ray.dir;
@@ -424,14 +427,14 @@ namespace embree
          }
 
         if (valid0)
-          found |= intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer0,tp0.lower,epilog);
+          found |= intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer0,tp0.lower,epilog,u_range);
           
         /* the far hit cannot be closer, thus skip if we hit entry already */
         valid1 &= tp1.lower+dt <= ray.tfar;
         
         /* iterate over second hit */
         if (valid1)
-          found |= intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer1,tp1.upper,epilog);
+          found |= intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer1,tp1.upper,epilog,u_range);
 
         stack.pop();
         
@@ -462,7 +465,7 @@ namespace embree
         const float dt = dot(curve0.center()-ray.org,ray.dir)*rcp(dot(ray.dir,ray.dir));
         const Vec3ff ref(madd(Vec3fa(dt),ray.dir,ray.org),0.0f);
         const NativeCurve3ff curve1 = curve0-ref;
-        return intersect_bezier_recursive_jacobian(ray,dt,curve1,epilog);
+        return intersect_bezier_recursive_jacobian(ray,dt,curve1,epilog,geom->subSegmentRange(primID));
       }
     };
 
@@ -504,7 +507,7 @@ namespace embree
         const float dt = dot(curve0.center()-ray.org,ray.dir)*rcp(dot(ray.dir,ray.dir));
         const Vec3ff ref(madd(Vec3fa(dt),ray.dir,ray.org),0.0f);
         const NativeCurve3ff curve1 = curve0-ref;
-        return intersect_bezier_recursive_jacobian(ray,dt,curve1,epilog);
+        return intersect_bezier_recursive_jacobian(ray,dt,curve1,epilog,geom->subSegmentRange(primID));
       }
     };
   }
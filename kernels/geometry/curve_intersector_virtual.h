@@ -32,6 +32,7 @@
 #include "curve_intersector_ribbon.h"
 #include "curve_intersector_oriented.h"
 #include "curve_intersector_sweep.h"
+#include "curve_intersector_lod.h"
 
 namespace embree
 {
@@ -463,17 +464,17 @@ namespace embree
       static VirtualCurveIntersector::Intersectors CurveNiIntersectors()
     {
       VirtualCurveIntersector::Intersectors intersectors;
-      intersectors.intersect1 = (VirtualCurveIntersector::Intersect1Ty) &CurveNiIntersector1<N>::template intersect_t<SweepCurve1Intersector1<Curve>, Intersect1Epilog1<true> >;
-      intersectors.occluded1  = (VirtualCurveIntersector::Occluded1Ty)  &CurveNiIntersector1<N>::template occluded_t <SweepCurve1Intersector1<Curve>, Occluded1Epilog1<true> >;
-      intersectors.intersect4 = (VirtualCurveIntersector::Intersect4Ty)&CurveNiIntersectorK<N,4>::template intersect_t<SweepCurve1IntersectorK<Curve,4>, Intersect1KEpilog1<4,true> >;
-      intersectors.occluded4  = (VirtualCurveIntersector::Occluded4Ty) &CurveNiIntersectorK<N,4>::template occluded_t <SweepCurve1IntersectorK<Curve,4>, Occluded1KEpilog1<4,true> >;
+      intersectors.intersect1 = (VirtualCurveIntersector::Intersect1Ty) &CurveNiIntersector1<N>::template intersect_t<CurveLOD1Intersector1<SweepCurve1Intersector1<Curve>,RibbonCurve1Intersector1<Curve> >, CurveLODEpilog<Intersect1Epilog1<true>,Intersect1EpilogMU<VSIZEX,true> > >;
+      intersectors.occluded1  = (VirtualCurveIntersector::Occluded1Ty)  &CurveNiIntersector1<N>::template occluded_t <CurveLOD1Intersector1<SweepCurve1Intersector1<Curve>,RibbonCurve1Intersector1<Curve> >, CurveLODEpilog<Occluded1Epilog1<true>,Occluded1EpilogMU<VSIZEX,true> > >;
+      intersectors.intersect4 = (VirtualCurveIntersector::Intersect4Ty)&CurveNiIntersectorK<N,4>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,4>,RibbonCurve1IntersectorK<Curve,4>,4>, CurveLODEpilog<Intersect1KEpilog1<4,true>,Intersect1KEpilogMU<VSIZEX,4,true> > >;
+      intersectors.occluded4  = (VirtualCurveIntersector::Occluded4Ty) &CurveNiIntersectorK<N,4>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,4>,RibbonCurve1IntersectorK<Curve,4>,4>, CurveLODEpilog<Occluded1KEpilog1<4,true>,Occluded1KEpilogMU<VSIZEX,4,true> > >;
 #if defined(__AVX__)
-      intersectors.intersect8 = (VirtualCurveIntersector::Intersect8Ty)&CurveNiIntersectorK<N,8>::template intersect_t<SweepCurve1IntersectorK<Curve,8>, Intersect1KEpilog1<8,true> >;
-      intersectors.occluded8  = (VirtualCurveIntersector::Occluded8Ty) &CurveNiIntersectorK<N,8>::template occluded_t <SweepCurve1IntersectorK<Curve,8>, Occluded1KEpilog1<8,true> >;
+      intersectors.intersect8 = (VirtualCurveIntersector::Intersect8Ty)&CurveNiIntersectorK<N,8>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,8>,RibbonCurve1IntersectorK<Curve,8>,8>, CurveLODEpilog<Intersect1KEpilog1<8,true>,Intersect1KEpilogMU<VSIZEX,8,true> > >;
+      intersectors.occluded8  = (VirtualCurveIntersector::Occluded8Ty) &CurveNiIntersectorK<N,8>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,8>,RibbonCurve1IntersectorK<Curve,8>,8>, CurveLODEpilog<Occluded1KEpilog1<8,true>,Occluded1KEpilogMU<VSIZEX,8,true> > >;
 #endif
 #if defined(__AVX512F__)
-      intersectors.intersect16 = (VirtualCurveIntersector::Intersect16Ty)&CurveNiIntersectorK<N,16>::template intersect_t<SweepCurve1IntersectorK<Curve,16>, Intersect1KEpilog1<16,true> >;
-      intersectors.occluded16  = (VirtualCurveIntersector::Occluded16Ty) &CurveNiIntersectorK<N,16>::template occluded_t <SweepCurve1IntersectorK<Curve,16>, Occluded1KEpilog1<16,true> >;
+      intersectors.intersect16 = (VirtualCurveIntersector::Intersect16Ty)&CurveNiIntersectorK<N,16>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,16>,RibbonCurve1IntersectorK<Curve,16>,16>, CurveLODEpilog<Intersect1KEpilog1<16,true>,Intersect1KEpilogMU<VSIZEX,16,true> > >;
+      intersectors.occluded16  = (VirtualCurveIntersector::Occluded16Ty) &CurveNiIntersectorK<N,16>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,16>,RibbonCurve1IntersectorK<Curve,16>,16>, CurveLODEpilog<Occluded1KEpilog1<16,true>,Occluded1KEpilogMU<VSIZEX,16,true> > >;
 #endif
       return intersectors;
     }
@@ -482,17 +483,17 @@ namespace embree
       static VirtualCurveIntersector::Intersectors CurveNvIntersectors()
     {
       VirtualCurveIntersector::Intersectors intersectors;
-      intersectors.intersect1 = (VirtualCurveIntersector::Intersect1Ty) &CurveNvIntersector1<N>::template intersect_t<SweepCurve1Intersector1<Curve>, Intersect1Epilog1<true> >;
-      intersectors.occluded1  = (VirtualCurveIntersector::Occluded1Ty)  &CurveNvIntersector1<N>::template occluded_t <SweepCurve1Intersector1<Curve>, Occluded1Epilog1<true> >;
-      intersectors.intersect4 = (VirtualCurveIntersector::Intersect4Ty)&CurveNvIntersectorK<N,4>::template intersect_t<SweepCurve1IntersectorK<Curve,4>, Intersect1KEpilog1<4,true> >;
-      intersectors.occluded4  = (VirtualCurveIntersector::Occluded4Ty) &CurveNvIntersectorK<N,4>::template occluded_t <SweepCurve1IntersectorK<Curve,4>, Occluded1KEpilog1<4,true> >;
+      intersectors.intersect1 = (VirtualCurveIntersector::Intersect1Ty) &CurveNvIntersector1<N>::template intersect_t<CurveLOD1Intersector1<SweepCurve1Intersector1<Curve>,RibbonCurve1Intersector1<Curve> >, CurveLODEpilog<Intersect1Epilog1<true>,Intersect1EpilogMU<VSIZEX,true> > >;
+      intersectors.occluded1  = (VirtualCurveIntersector::Occluded1Ty)  &CurveNvIntersector1<N>::template occluded_t <CurveLOD1Intersector1<SweepCurve1Intersector1<Curve>,RibbonCurve1Intersector1<Curve> >, CurveLODEpilog<Occluded1Epilog1<true>,Occluded1EpilogMU<VSIZEX,true> > >;
+      intersectors.intersect4 = (VirtualCurveIntersector::Intersect4Ty)&CurveNvIntersectorK<N,4>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,4>,RibbonCurve1IntersectorK<Curve,4>,4>, CurveLODEpilog<Intersect1KEpilog1<4,true>,Intersect1KEpilogMU<VSIZEX,4,true> > >;
+      intersectors.occluded4  = (VirtualCurveIntersector::Occluded4Ty) &CurveNvIntersectorK<N,4>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,4>,RibbonCurve1IntersectorK<Curve,4>,4>, CurveLODEpilog<Occluded1KEpilog1<4,true>,Occluded1KEpilogMU<VSIZEX,4,true> > >;
 #if defined(__AVX__)
-      intersectors.intersect8 = (VirtualCurveIntersector::Intersect8Ty)&CurveNvIntersectorK<N,8>::template intersect_t<SweepCurve1IntersectorK<Curve,8>, Intersect1KEpilog1<8,true> >;
-      intersectors.occluded8  = (VirtualCurveIntersector::Occluded8Ty) &CurveNvIntersectorK<N,8>::template occluded_t <SweepCurve1IntersectorK<Curve,8>, Occluded1KEpilog1<8,true> >;
+      intersectors.intersect8 = (VirtualCurveIntersector::Intersect8Ty)&CurveNvIntersectorK<N,8>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,8>,RibbonCurve1IntersectorK<Curve,8>,8>, CurveLODEpilog<Intersect1KEpilog1<8,true>,Intersect1KEpilogMU<VSIZEX,8,true> > >;
+      intersectors.occluded8  = (VirtualCurveIntersector::Occluded8Ty) &CurveNvIntersectorK<N,8>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,8>,RibbonCurve1IntersectorK<Curve,8>,8>, CurveLODEpilog<Occluded1KEpilog1<8,true>,Occluded1KEpilogMU<VSIZEX,8,true> > >;
 #endif
 #if defined(__AVX512F__)
-      intersectors.intersect16 = (VirtualCurveIntersector::Intersect16Ty)&CurveNvIntersectorK<N,16>::template intersect_t<SweepCurve1IntersectorK<Curve,16>, Intersect1KEpilog1<16,true> >;
-      intersectors.occluded16  = (VirtualCurveIntersector::Occluded16Ty) &CurveNvIntersectorK<N,16>::template occluded_t <SweepCurve1IntersectorK<Curve,16>, Occluded1KEpilog1<16,true> >;
+      intersectors.intersect16 = (VirtualCurveIntersector::Intersect16Ty)&CurveNvIntersectorK<N,16>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,16>,RibbonCurve1IntersectorK<Curve,16>,16>, CurveLODEpilog<Intersect1KEpilog1<16,true>,Intersect1KEpilogMU<VSIZEX,16,true> > >;
+      intersectors.occluded16  = (VirtualCurveIntersector::Occluded16Ty) &CurveNvIntersectorK<N,16>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,16>,RibbonCurve1IntersectorK<Curve,16>,16>, CurveLODEpilog<Occluded1KEpilog1<16,true>,Occluded1KEpilogMU<VSIZEX,16,true> > >;
 #endif
       return intersectors;
     }
@@ -501,17 +502,17 @@ namespace embree
       static VirtualCurveIntersector::Intersectors CurveNiMBIntersectors()
     {
       VirtualCurveIntersector::Intersectors intersectors;
-      intersectors.intersect1 = (VirtualCurveIntersector::Intersect1Ty) &CurveNiMBIntersector1<N>::template intersect_t<SweepCurve1Intersector1<Curve>, Intersect1Epilog1<true> >;
-      intersectors.occluded1  = (VirtualCurveIntersector::Occluded1Ty)  &CurveNiMBIntersector1<N>::template occluded_t <SweepCurve1Intersector1<Curve>, Occluded1Epilog1<true> >;
-      intersectors.intersect4 = (VirtualCurveIntersector::Intersect4Ty)&CurveNiMBIntersectorK<N,4>::template intersect_t<SweepCurve1IntersectorK<Curve,4>, Intersect1KEpilog1<4,true> >;
-      intersectors.occluded4  = (VirtualCurveIntersector::Occluded4Ty) &CurveNiMBIntersectorK<N,4>::template occluded_t <SweepCurve1IntersectorK<Curve,4>, Occluded1KEpilog1<4,true> >;
+      intersectors.intersect1 = (VirtualCurveIntersector::Intersect1Ty) &CurveNiMBIntersector1<N>::template intersect_t<CurveLOD1Intersector1<SweepCurve1Intersector1<Curve>,RibbonCurve1Intersector1<Curve> >, CurveLODEpilog<Intersect1Epilog1<true>,Intersect1EpilogMU<VSIZEX,true> > >;
+      intersectors.occluded1  = (VirtualCurveIntersector::Occluded1Ty)  &CurveNiMBIntersector1<N>::template occluded_t <CurveLOD1Intersector1<SweepCurve1Intersector1<Curve>,RibbonCurve1Intersector1<Curve> >, CurveLODEpilog<Occluded1Epilog1<true>,Occluded1EpilogMU<VSIZEX,true> > >;
+      intersectors.intersect4 = (VirtualCurveIntersector::Intersect4Ty)&CurveNiMBIntersectorK<N,4>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,4>,RibbonCurve1IntersectorK<Curve,4>,4>, CurveLODEpilog<Intersect1KEpilog1<4,true>,Intersect1KEpilogMU<VSIZEX,4,true> > >;
+      intersectors.occluded4  = (VirtualCurveIntersector::Occluded4Ty) &CurveNiMBIntersectorK<N,4>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,4>,RibbonCurve1IntersectorK<Curve,4>,4>, CurveLODEpilog<Occluded1KEpilog1<4,true>,Occluded1KEpilogMU<VSIZEX,4,true> > >;
 #if defined(__AVX__)
-      intersectors.intersect8 = (VirtualCurveIntersector::Intersect8Ty)&CurveNiMBIntersectorK<N,8>::template intersect_t<SweepCurve1IntersectorK<Curve,8>, Intersect1KEpilog1<8,true> >;
-      intersectors.occluded8  = (VirtualCurveIntersector::Occluded8Ty) &CurveNiMBIntersectorK<N,8>::template occluded_t <SweepCurve1IntersectorK<Curve,8>, Occluded1KEpilog1<8,true> >;
+      intersectors.intersect8 = (VirtualCurveIntersector::Intersect8Ty)&CurveNiMBIntersectorK<N,8>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,8>,RibbonCurve1IntersectorK<Curve,8>,8>, CurveLODEpilog<Intersect1KEpilog1<8,true>,Intersect1KEpilogMU<VSIZEX,8,true> > >;
+      intersectors.occluded8  = (VirtualCurveIntersector::Occluded8Ty) &CurveNiMBIntersectorK<N,8>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,8>,RibbonCurve1IntersectorK<Curve,8>,8>, CurveLODEpilog<Occluded1KEpilog1<8,true>,Occluded1KEpilogMU<VSIZEX,8,true> > >;
 #endif
 #if defined(__AVX512F__)
-      intersectors.intersect16 = (VirtualCurveIntersector::Intersect16Ty)&CurveNiMBIntersectorK<N,16>::template intersect_t<SweepCurve1IntersectorK<Curve,16>, Intersect1KEpilog1<16,true> >;
-      intersectors.occluded16  = (VirtualCurveIntersector::Occluded16Ty) &CurveNiMBIntersectorK<N,16>::template occluded_t <SweepCurve1IntersectorK<Curve,16>, Occluded1KEpilog1<16,true> >;
+      intersectors.intersect16 = (VirtualCurveIntersector::Intersect16Ty)&CurveNiMBIntersectorK<N,16>::template intersect_t<CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,16>,RibbonCurve1IntersectorK<Curve,16>,16>, CurveLODEpilog<Intersect1KEpilog1<16,true>,Intersect1KEpilogMU<VSIZEX,16,true> > >;
+      intersectors.occluded16  = (VirtualCurveIntersector::Occluded16Ty) &CurveNiMBIntersectorK<N,16>::template occluded_t <CurveLOD1IntersectorK<SweepCurve1IntersectorK<Curve,16>,RibbonCurve1IntersectorK<Curve,16>,16>, CurveLODEpilog<Occluded1KEpilog1<16,true>,Occluded1KEpilogMU<VSIZEX,16,true> > >;
 #endif
       return intersectors;
     }
@@ -32,6 +32,7 @@ namespace embree
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)object, user_context, context->args);
+        newcontext.sample = context->sample;
         object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
@@ -62,6 +63,7 @@ namespace embree
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)object, user_context, context->args);
+        newcontext.sample = context->sample;
         object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
@@ -128,6 +130,7 @@ namespace embree
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)object, user_context, context->args);
+        newcontext.sample = context->sample;
         object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
@@ -157,6 +160,7 @@ namespace embree
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)object, user_context, context->args);
+        newcontext.sample = context->sample;
         object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
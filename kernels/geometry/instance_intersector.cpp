@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "instance_intersector.h"
+#include "trianglev_intersector.h"
 #include "../common/scene.h"
 #include "../common/instance_stack.h"
 
@@ -11,6 +12,119 @@ namespace embree
 {
   namespace isa
   {
+    /* intersection of unrolled instances, the unrolled triangles are
+     * already in world space, thus the ray does not get transformed,
+     * but geometry normals get reported in object space as for
+     * regular instances */
+
+    template<typename Intersector>
+    static __forceinline void intersectUnrolled(RayHit& ray, RayQueryContext* context, const Instance* instance)
+    {
+      typename Intersector::Precalculations pre(ray,nullptr);
+      for (size_t i=0; i<instance->numUnrolled; i++)
+        Intersector::intersect(pre,ray,context,instance->unrolled[i]);
+    }
+
+    static void intersectUnrolled(RayHit& ray, RayQueryContext* context, const Instance* instance)
+    {
+      const float tfar = ray.tfar;
+      if (instance->unrolledRobust) intersectUnrolled<TriangleMvIntersector1Pluecker<4,true>>(ray,context,instance);
+      else                          intersectUnrolled<TriangleMvIntersector1Moeller <4,true>>(ray,context,instance);
+      if (ray.tfar < tfar) {
+        const Vec3fa Ng = xfmVector(instance->unrolledNormalXfm,Vec3fa(ray.Ng));
+        ray.Ng = Vec3f(Ng.x,Ng.y,Ng.z);
+      }
+    }
+
+    template<typename Intersector>
+    static __forceinline void occludedUnrolled(Ray& ray, RayQueryContext* context, const Instance* instance)
+    {
+      typename Intersector::Precalculations pre(ray,nullptr);
+      for (size_t i=0; i<instance->numUnrolled; i++) {
+        if (Intersector::occluded(pre,ray,context,instance->unrolled[i])) {
+          ray.tfar = neg_inf;
+          return;
+        }
+      }
+    }
+
+    static void occludedUnrolled(Ray& ray, RayQueryContext* context, const Instance* instance)
+    {
+      if (instance->unrolledRobust) occludedUnrolled<TriangleMvIntersector1Pluecker<4,true>>(ray,context,instance);
+      else                          occludedUnrolled<TriangleMvIntersector1Moeller <4,true>>(ray,context,instance);
+    }
+
+    template<typename Intersector, int K>
+    static __forceinline void intersectUnrolled(const vbool<K>& valid, RayHitK<K>& ray, RayQueryContext* context, const Instance* instance)
+    {
+      typename Intersector::Precalculations pre(valid,ray);
+      for (size_t i=0; i<instance->numUnrolled; i++)
+        Intersector::intersect(valid,pre,ray,context,instance->unrolled[i]);
+    }
+
+    template<int K>
+    static void intersectUnrolled(const vbool<K>& valid, RayHitK<K>& ray, RayQueryContext* context, const Instance* instance)
+    {
+      const vfloat<K> tfar = ray.tfar;
+      if (instance->unrolledRobust) intersectUnrolled<TriangleMvIntersectorKPluecker<4,K,true>>(valid,ray,context,instance);
+      else                          intersectUnrolled<TriangleMvIntersectorKMoeller <4,K,true>>(valid,ray,context,instance);
+      const vbool<K> hit = valid & (ray.tfar < tfar);
+      if (any(hit)) {
+        const Vec3vf<K> Ng = xfmVector(LinearSpace3vf<K>(instance->unrolledNormalXfm),ray.Ng);
+        ray.Ng.x = select(hit,Ng.x,ray.Ng.x);
+        ray.Ng.y = select(hit,Ng.y,ray.Ng.y);
+        ray.Ng.z = select(hit,Ng.z,ray.Ng.z);
+      }
+    }
+
+    template<typename Intersector, int K>
+    static __forceinline void occludedUnrolled(const vbool<K>& valid_i, RayK<K>& ray, RayQueryContext* context, const Instance* instance)
+    {
+      vbool<K> valid = valid_i;
+      typename Intersector::Precalculations pre(valid,ray);
+      for (size_t i=0; i<instance->numUnrolled; i++) {
+        valid &= !Intersector::occluded(valid,pre,ray,context,instance->unrolled[i]);
+        if (none(valid)) break;
+      }
+      ray.tfar = select(valid_i & !valid,vfloat<K>(neg_inf),ray.tfar);
+    }
+
+    template<int K>
+    static void occludedUnrolled(const vbool<K>& valid, RayK<K>& ray, RayQueryContext* context, const Instance* instance)
+    {
+      if (instance->unrolledRobust) occludedUnrolled<TriangleMvIntersectorKPluecker<4,K,true>>(valid,ray,context,instance);
+      else                          occludedUnrolled<TriangleMvIntersectorKMoeller <4,K,true>>(valid,ray,context,instance);
+    }
+
+
+    /* tests the ray in object space against the bounds of the instanced
+     * scene, which form an oriented box in world space that is much
+     * tighter than the world space bounds of rotated instances, thus
+     * rays that only hit the top-level bounds skip the traversal of the
+     * instanced scene */
+
+    static __forceinline bool intersectObjectBounds(const Instance* instance, const Vec3fa& org, const Vec3fa& dir, float tnear, float tfar)
+    {
+      const BBox3fa bounds = instance->object->bounds.bounds();
+      const Vec3fa rdir = rcp_safe(dir);
+      const Vec3fa t0 = (bounds.lower-org)*rdir;
+      const Vec3fa t1 = (bounds.upper-org)*rdir;
+      const float tNear = max(reduce_max(min(t0,t1)),tnear);
+      const float tFar  = min(reduce_min(max(t0,t1)),tfar);
+      return tNear*(1.0f-3.0f*float(ulp)) <= tFar*(1.0f+3.0f*float(ulp));
+    }
+
+    template<int K>
+    static __forceinline vbool<K> intersectObjectBounds(const vbool<K>& valid, const Instance* instance, const Vec3vf<K>& org, const Vec3vf<K>& dir, const vfloat<K>& tnear, const vfloat<K>& tfar)
+    {
+      const BBox3fa bounds = instance->object->bounds.bounds();
+      const Vec3vf<K> rdir = rcp_safe(dir);
+      const Vec3vf<K> t0 = (Vec3vf<K>(bounds.lower.x,bounds.lower.y,bounds.lower.z)-org)*rdir;
+      const Vec3vf<K> t1 = (Vec3vf<K>(bounds.upper.x,bounds.upper.y,bounds.upper.z)-org)*rdir;
+      const vfloat<K> tNear = max(max(min(t0.x,t1.x),min(t0.y,t1.y)),max(min(t0.z,t1.z),tnear));
+      const vfloat<K> tFar  = min(min(max(t0.x,t1.x),max(t0.y,t1.y)),min(max(t0.z,t1.z),tfar));
+      return valid & (tNear*(1.0f-3.0f*float(ulp)) <= tFar*(1.0f+3.0f*float(ulp)));
+    }
 
     void InstanceIntersector1::intersect(const Precalculations& pre, RayHit& ray, RayQueryContext* context, const InstancePrimitive& prim)
     {
@@ -24,13 +138,22 @@ namespace embree
       RTCRayQueryContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_, 0)))
       {
+        if (instance->isUnrolled()) {
+          RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
+          newcontext.sample = context->sample;
+          intersectUnrolled(ray, &newcontext, instance);
+          instance_id_stack::pop(user_context);
+          return;
+        }
         const AffineSpace3fa world2local = instance->getWorld2Local();
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
+        newcontext.sample = context->sample;
+        if (likely(!instance->objectBoundsTest || intersectObjectBounds(instance, ray.org, ray.dir, ray.tnear(), ray.tfar)))
+          instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -51,13 +174,22 @@ namespace embree
       bool occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_, 0)))
       {
+        if (instance->isUnrolled()) {
+          RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
+          newcontext.sample = context->sample;
+          occludedUnrolled(ray, &newcontext, instance);
+          instance_id_stack::pop(user_context);
+          return ray.tfar < 0.0f;
+        }
         const AffineSpace3fa world2local = instance->getWorld2Local();
         const Vec3ff ray_org = ray.org;
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
+        newcontext.sample = context->sample;
+        if (likely(!instance->objectBoundsTest || intersectObjectBounds(instance, ray.org, ray.dir, ray.tnear(), ray.tfar)))
+          instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
@@ -119,7 +251,9 @@ namespace embree
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
+        newcontext.sample = context->sample;
+        if (likely(!instance->objectBoundsTest || intersectObjectBounds(instance, ray.org, ray.dir, ray.tnear(), ray.tfar)))
+          instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -146,7 +280,9 @@ namespace embree
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
+        newcontext.sample = context->sample;
+        if (likely(!instance->objectBoundsTest || intersectObjectBounds(instance, ray.org, ray.dir, ray.tnear(), ray.tfar)))
+          instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
@@ -203,13 +339,21 @@ namespace embree
       RTCRayQueryContext* user_context = context->user;
       if (likely(instance_id_stack::push(user_context, prim.instID_, 0)))
       {
+        if (instance->isUnrolled()) {
+          RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
+          intersectUnrolled<K>(valid, ray, &newcontext, instance);
+          instance_id_stack::pop(user_context);
+          return;
+        }
         AffineSpace3vf<K> world2local = instance->getWorld2Local();
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect(valid, ray, &newcontext);
+        const vbool<K> active = instance->objectBoundsTest ? intersectObjectBounds<K>(valid, instance, ray.org, ray.dir, ray.tnear(), ray.tfar) : valid;
+        if (any(active))
+          instance->object->intersectors.intersect(active, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -232,13 +376,21 @@ namespace embree
       vbool<K> occluded = false;
       if (likely(instance_id_stack::push(user_context, prim.instID_, 0)))
       {
+        if (instance->isUnrolled()) {
+          RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
+          occludedUnrolled<K>(valid, ray, &newcontext, instance);
+          instance_id_stack::pop(user_context);
+          return ray.tfar < 0.0f;
+        }
         AffineSpace3vf<K> world2local = instance->getWorld2Local();
         const Vec3vf<K> ray_org = ray.org;
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded(valid, ray, &newcontext);
+        const vbool<K> active = instance->objectBoundsTest ? intersectObjectBounds<K>(valid, instance, ray.org, ray.dir, ray.tnear(), ray.tfar) : valid;
+        if (any(active))
+          instance->object->intersectors.occluded(active, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
@@ -268,7 +420,9 @@ namespace embree
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.intersect(valid, ray, &newcontext);
+        const vbool<K> active = instance->objectBoundsTest ? intersectObjectBounds<K>(valid, instance, ray.org, ray.dir, ray.tnear(), ray.tfar) : valid;
+        if (any(active))
+          instance->object->intersectors.intersect(active, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         instance_id_stack::pop(user_context);
@@ -297,7 +451,9 @@ namespace embree
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
-        instance->object->intersectors.occluded(valid, ray, &newcontext);
+        const vbool<K> active = instance->objectBoundsTest ? intersectObjectBounds<K>(valid, instance, ray.org, ray.dir, ray.tnear(), ray.tfar) : valid;
+        if (any(active))
+          instance->object->intersectors.occluded(active, ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
         occluded = ray.tfar < 0.0f;
@@ -17,6 +17,56 @@ namespace embree
     };
 
 
+    /*! records a hit of a multi-hit query after invoking the filter functions */
+    template<bool filter>
+    __forceinline bool recordMultiHit(RayHit& ray, RayQueryContext* context, Geometry* geometry,
+                                      const unsigned int geomID, const unsigned int primID,
+                                      const float t, const float u, const float v, const Vec3fa& Ng)
+    {
+      HitK<1> h(context->user,geomID,primID,u,v,Ng);
+#if defined(EMBREE_FILTER_FUNCTION)
+      if (filter) {
+        if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          const float old_t = ray.tfar;
+          ray.tfar = t;
+          const bool found = runIntersectionFilter1(geometry,ray,context,h);
+          ray.tfar = old_t;
+          if (!found) return false;
+        }
+      }
+#endif
+      if (!context->multiHit->insert(t,h))
+        return false;
+
+      /* cull the traversal against the last hit slot */
+      ray.tfar = context->multiHit->cullDistance(ray.tfar);
+      return true;
+    }
+
+    /*! reports the hit of an any-hit query after invoking the intersection
+     *  filter functions, which see the ray passed to the query */
+    template<bool filter>
+    __forceinline bool recordAnyHit(RayQueryContext* context, Geometry* geometry,
+                                    const unsigned int geomID, const unsigned int primID,
+                                    const float t, const float u, const float v, const Vec3fa& Ng)
+    {
+      RayHit& rayhit = *(RayHit*)context->anyHit;
+      HitK<1> h(context->user,geomID,primID,u,v,Ng);
+      const float old_t = rayhit.tfar;
+      rayhit.tfar = t;
+#if defined(EMBREE_FILTER_FUNCTION)
+      if (filter) {
+        if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          const bool found = runIntersectionFilter1(geometry,rayhit,context,h);
+          if (!found) rayhit.tfar = old_t;
+          return found;
+        }
+      }
+#endif
+      copyHitToRay(rayhit,h);
+      return true;
+    }
+
     template<bool filter>
     struct Intersect1Epilog1
     {
@@ -42,6 +92,10 @@ namespace embree
 #endif
         hit.finalize();
 
+        /* multi-hit queries record the hit instead of updating the ray */
+        if (unlikely(context->multiHit))
+          return recordMultiHit<filter>(ray,context,geometry,geomID,primID,hit.t,hit.u,hit.v,hit.Ng);
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
@@ -98,6 +152,10 @@ namespace embree
 #endif
         hit.finalize();
 
+        /* any-hit queries terminate like occlusion queries but report the hit */
+        if (unlikely(context->anyHit))
+          return recordAnyHit<filter>(context,geometry,geomID,primID,hit.t,hit.u,hit.v,hit.Ng);
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
@@ -237,6 +295,27 @@ namespace embree
         Scene* scene MAYBE_UNUSED = context->scene;
         vbool<M> valid = valid_i;
         hit.finalize();
+
+        /* multi-hit queries record all hits instead of updating the ray */
+        if (unlikely(context->multiHit))
+        {
+          bool foundhit = false;
+          while (any(valid))
+          {
+            const size_t i = select_min(valid,hit.vt);
+            clear(valid,i);
+            const unsigned int geomID = geomIDs[i];
+            Geometry* geometry = scene->get(geomID);
+#if defined(EMBREE_RAY_MASK)
+            if ((geometry->mask & ray.mask) == 0) continue;
+#endif
+            const Vec2f uv = hit.uv(i);
+            foundhit |= recordMultiHit<filter>(ray,context,geometry,geomID,primIDs[i],hit.vt[i],uv.x,uv.y,hit.Ng(i));
+            valid &= hit.vt <= ray.tfar;
+          }
+          return foundhit;
+        }
+
         size_t i = select_min(valid,hit.vt);
         unsigned int geomID = geomIDs[i];
 
@@ -319,6 +398,24 @@ namespace embree
       __forceinline bool operator() (const vbool<M>& valid_i, Hit& hit) const
       {
         Scene* scene MAYBE_UNUSED = context->scene;
+
+        /* any-hit queries terminate like occlusion queries but report the hit */
+        if (unlikely(context->anyHit))
+        {
+          hit.finalize();
+          for (size_t m=movemask(valid_i), i=bsf(m); m!=0; m=btc(m,i), i=bsf(m))
+          {
+            const unsigned int geomID = geomIDs[i];
+            Geometry* geometry = scene->get(geomID);
+#if defined(EMBREE_RAY_MASK)
+            if ((geometry->mask & ray.mask) == 0) continue;
+#endif
+            const Vec2f uv = hit.uv(i);
+            if (recordAnyHit<filter>(context,geometry,geomID,primIDs[i],hit.t(i),uv.x,uv.y,hit.Ng(i))) return true;
+          }
+          return false;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION) || defined(EMBREE_RAY_MASK)
         if (unlikely(filter))
@@ -395,6 +492,21 @@ namespace embree
         vbool<M> valid = valid_i;
         hit.finalize();
 
+        /* multi-hit queries record all hits instead of updating the ray */
+        if (unlikely(context->multiHit))
+        {
+          bool foundhit = false;
+          while (any(valid))
+          {
+            const size_t i = select_min(valid,hit.vt);
+            clear(valid,i);
+            const Vec2f uv = hit.uv(i);
+            foundhit |= recordMultiHit<filter>(ray,context,geometry,geomID,primID,hit.t(i),uv.x,uv.y,hit.Ng(i));
+            valid &= hit.vt <= ray.tfar;
+          }
+          return foundhit;
+        }
+
         size_t i = select_min(valid,hit.vt);
 
         /* intersection filter test */
@@ -464,6 +576,18 @@ namespace embree
         if ((geometry->mask & ray.mask) == 0) return false;
 #endif
 
+        /* any-hit queries terminate like occlusion queries but report the hit */
+        if (unlikely(context->anyHit))
+        {
+          hit.finalize();
+          for (size_t m=movemask(valid), i=bsf(m); m!=0; m=btc(m,i), i=bsf(m))
+          {
+            const Vec2f uv = hit.uv(i);
+            if (recordAnyHit<filter>(context,geometry,geomID,primID,hit.t(i),uv.x,uv.y,hit.Ng(i))) return true;
+          }
+          return false;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter()))
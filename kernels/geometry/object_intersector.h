@@ -5,6 +5,7 @@
 
 #include "object.h"
 #include "../common/ray.h"
+#include "../common/hit.h"
 
 namespace embree
 {
@@ -32,8 +33,36 @@ namespace embree
           return;
 #endif
 
+        /* multi-hit queries record the hit reported by the user geometry */
+        if (unlikely(context->multiHit)) {
+          intersectMultiHit(ray,context,accel,prim);
+          return;
+        }
+
         accel->intersect(ray,prim.geomID(),prim.primID(),context);
       }
+
+      static __forceinline void intersectMultiHit(RayHit& ray, RayQueryContext* context, AccelSet* accel, const Primitive& prim)
+      {
+        RayHit uray = ray;
+        uray.geomID = RTC_INVALID_GEOMETRY_ID;
+        accel->intersect(uray,prim.geomID(),prim.primID(),context);
+        if (uray.geomID == RTC_INVALID_GEOMETRY_ID)
+          return;
+
+        Hit hit;
+        hit.Ng = Vec3<float>(uray.Ng.x,uray.Ng.y,uray.Ng.z);
+        hit.u = uray.u;
+        hit.v = uray.v;
+        hit.primID = uray.primID;
+        hit.geomID = uray.geomID;
+        instance_id_stack::copy_UU(uray.instID,hit.instID);
+#if defined(RTC_GEOMETRY_INSTANCE_ARRAY)
+        instance_id_stack::copy_UU(uray.instPrimID,hit.instPrimID);
+#endif
+        if (context->multiHit->insert(uray.tfar,hit))
+          ray.tfar = context->multiHit->cullDistance(ray.tfar);
+      }
       
       static __forceinline bool occluded(const Precalculations& pre, Ray& ray, RayQueryContext* context, const Primitive& prim)
       {
@@ -44,10 +73,28 @@ namespace embree
           return false;
 #endif
 
+        /* any-hit queries need the hit reported by the user geometry */
+        if (unlikely(context->anyHit))
+          return occludedAnyHit(ray,context,accel,prim);
+
         accel->occluded(ray,prim.geomID(),prim.primID(),context);
         return ray.tfar < 0.0f;
       }
 
+      static __forceinline bool occludedAnyHit(Ray& ray, RayQueryContext* context, AccelSet* accel, const Primitive& prim)
+      {
+        RayHit uray(ray);
+        accel->intersect(uray,prim.geomID(),prim.primID(),context);
+        if (uray.geomID == RTC_INVALID_GEOMETRY_ID)
+          return false;
+
+        RayHit& rayhit = *(RayHit*)context->anyHit;
+        rayhit.tfar = uray.tfar;
+        copyHitToRay(rayhit,uray);
+        ray.tfar = neg_inf;
+        return true;
+      }
+
       static __forceinline bool intersect(const Precalculations& pre, Ray& ray, RayQueryContext* context, const Primitive& prim) {
         return occluded(pre,ray,context,prim);
       }
@@ -84,6 +84,17 @@ namespace embree
       if (buildParams.buildBenchType & BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC) {
         Benchmark_Static_Create(state, params, buildParams, tutorial->ispc_scene.get(), RTC_BUILD_QUALITY_MEDIUM,RTC_BUILD_QUALITY_HIGH);
       }
+#if !defined(EMBREE_SYCL_TUTORIAL)
+      if (buildParams.buildBenchType & BuildBenchType::TRACE_FAST) {
+        Benchmark_Trace(state, params, buildParams, tutorial->ispc_scene.get(), BuildBenchType::TRACE_FAST);
+      }
+      if (buildParams.buildBenchType & BuildBenchType::TRACE_ROBUST) {
+        Benchmark_Trace(state, params, buildParams, tutorial->ispc_scene.get(), BuildBenchType::TRACE_ROBUST);
+      }
+      if (buildParams.buildBenchType & BuildBenchType::TRACE_WATERTIGHT) {
+        Benchmark_Trace(state, params, buildParams, tutorial->ispc_scene.get(), BuildBenchType::TRACE_WATERTIGHT);
+      }
+#endif
     }
     else
     {
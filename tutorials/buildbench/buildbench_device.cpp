@@ -5,12 +5,15 @@
 
 #include "../common/tutorial/tutorial_device.h"
 #include "../common/tutorial/scene_device.h"
+#include "../../common/algorithms/parallel_reduce.h"
 
 #ifdef USE_GOOGLE_BENCHMARK
 #include <benchmark/benchmark.h>
 #endif
 
 #include <thread>
+#include <random>
+#include <functional>
 
 namespace embree {
 
@@ -23,6 +26,9 @@ namespace embree {
   static const MAYBE_UNUSED size_t iterations_dynamic_dynamic    = 200;
   static const MAYBE_UNUSED size_t iterations_dynamic_static     = 50;
   static const MAYBE_UNUSED size_t iterations_static_static      = 30;
+  static const MAYBE_UNUSED size_t iterations_trace              = 10;
+
+  static const size_t num_trace_rays = 1024*1024;
   
   void convertTriangleMesh(ISPCTriangleMesh* mesh, RTCScene scene_out, RTCBuildQuality quality)
   {
@@ -626,6 +632,129 @@ namespace embree {
 #endif
   }
 
+  RTCSceneFlags getTraceSceneFlags(BuildBenchType type)
+  {
+    if      (type == BuildBenchType::TRACE_ROBUST    ) return RTC_SCENE_FLAG_ROBUST;     // Pluecker test
+    else if (type == BuildBenchType::TRACE_WATERTIGHT) return RTC_SCENE_FLAG_WATERTIGHT; // Woop test
+    else                                               return RTC_SCENE_FLAG_NONE;       // Moeller-Trumbore test
+  }
+
+  /* generates rays that start on a sphere around the scene and point to random locations inside the scene bounds */
+  void generateTraceRays(RTCScene scene, std::vector<Ray>& rays)
+  {
+    RTCBounds bounds;
+    rtcGetSceneBounds(scene,&bounds);
+    const Vec3fa lower(bounds.lower_x,bounds.lower_y,bounds.lower_z);
+    const Vec3fa upper(bounds.upper_x,bounds.upper_y,bounds.upper_z);
+    const Vec3fa center = 0.5f*(lower+upper);
+    const float radius = 0.5f*length(upper-lower);
+
+    std::mt19937 gen(0x12345678);
+    std::uniform_real_distribution<float> dist(0.0f,1.0f);
+    rays.resize(num_trace_rays);
+    for (size_t i=0; i<rays.size(); i++)
+    {
+      const float phi = 2.0f*float(pi)*dist(gen);
+      const float cosTheta = 2.0f*dist(gen)-1.0f;
+      const float sinTheta = sqrt(max(0.0f,1.0f-cosTheta*cosTheta));
+      const Vec3fa org = center + radius*Vec3fa(sinTheta*cos(phi),sinTheta*sin(phi),cosTheta);
+      const Vec3fa target = lower + Vec3fa(dist(gen),dist(gen),dist(gen))*(upper-lower);
+      rays[i] = Ray(org,normalize(target-org),0.0f,inf);
+    }
+  }
+
+  /* traces all rays in parallel and returns the number of hits */
+  size_t traceRays(RTCScene scene, const std::vector<Ray>& rays)
+  {
+    return parallel_reduce(size_t(0), rays.size(), size_t(4096), size_t(0), [&](const range<size_t>& r) -> size_t
+    {
+      size_t hits = 0;
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+        Ray ray = rays[i];
+        rtcIntersect1(scene,RTCRayHit_(ray));
+        hits += ray.geomID != RTC_INVALID_GEOMETRY_ID;
+      }
+      return hits;
+    }, std::plus<size_t>());
+  }
+
+  void Benchmark_Trace_Legacy(ISPCScene* scene_in, BenchParams& params, BuildBenchType type)
+  {
+    size_t benchmark_iterations = params.minTimeOrIterations;
+    if (benchmark_iterations <= 0)
+      benchmark_iterations = iterations_trace;
+
+    RTCScene scene = createScene(getTraceSceneFlags(type),RTC_BUILD_QUALITY_MEDIUM);
+    convertScene(scene,scene_in,RTC_BUILD_QUALITY_MEDIUM);
+    rtcCommitScene(scene);
+
+    std::vector<Ray> rays;
+    generateTraceRays(scene,rays);
+
+    size_t iterations = 0;
+    size_t hits = 0;
+    double time = 0.0;
+    for (size_t i=0; i<benchmark_iterations+params.skipIterations; i++)
+    {
+      double t0 = getSeconds();
+      hits = traceRays(scene,rays);
+      double t1 = getSeconds();
+      if (i >= params.skipIterations)
+      {
+        time += t1 - t0;
+        iterations++;
+      }
+    }
+
+    std::cout << "BENCHMARK_" << toUpperCase(getBuildBenchTypeString(type)) << " ";
+
+    if (iterations == 0) iterations = 1;
+    std::cout << iterations << " iterations, " << rays.size() << " rays, " << hits << " hits, "
+              << time/iterations << " s, "
+              << 1.0 / (time/iterations) * rays.size() / 1000000.0 << " Mrays/s" << std::endl;
+
+    rtcReleaseScene(scene);
+  }
+
+  void Benchmark_Trace(
+    BenchState& state,
+    BenchParams& params,
+    BuildBenchParams& buildParams,
+    ISPCScene* ispc_scene,
+    BuildBenchType type)
+  {
+#ifdef USE_GOOGLE_BENCHMARK
+    if (params.legacy) {
+      Benchmark_Trace_Legacy(ispc_scene, params, type);
+      return;
+    }
+
+    RTCScene scene = createScene(getTraceSceneFlags(type), RTC_BUILD_QUALITY_MEDIUM);
+    convertScene(scene, ispc_scene, RTC_BUILD_QUALITY_MEDIUM);
+    rtcCommitScene(scene);
+
+    std::vector<Ray> rays;
+    generateTraceRays(scene, rays);
+
+    // warm-up
+    for (int i = 0; i < params.minTimeOrIterations; ++i)
+      traceRays(scene, rays);
+
+    size_t hits = 0;
+    for (auto _ : *state.state)
+      hits = traceRays(scene, rays);
+
+    state.state->SetItemsProcessed(state.state->iterations() * rays.size());
+    state.state->counters["Rays"] = ::benchmark::Counter(rays.size());
+    state.state->counters["Hits"] = ::benchmark::Counter(hits);
+
+    rtcReleaseScene(scene);
+#else
+    Benchmark_Trace_Legacy(ispc_scene, params, type);
+#endif
+  }
+
   extern "C" void device_init (char* cfg)
   {
   }
@@ -27,6 +27,35 @@ namespace embree
     (&rprim->lower_x)[dim] = pos;
   }
 
+  /* offset of a moving primitive at some time step */
+  Vec3fa motionOffset(unsigned int primID, unsigned int timeStep) {
+    return 2.0f*Vec3fa(sinf(0.37f*primID+timeStep),cosf(0.61f*primID+2.0f*timeStep),sinf(0.13f*primID+3.0f*timeStep));
+  }
+
+  /* bounds of a moving primitive at some time, the primitive moves linearly between the time steps */
+  BBox3fa motionBounds(const RTCBuildPrimitive& prim, unsigned int numTimeSegments, float time)
+  {
+    const float t = time*float(numTimeSegments);
+    const unsigned int step = min((unsigned int)t,numTimeSegments-1);
+    const Vec3fa offset = lerp(motionOffset(prim.primID,step),motionOffset(prim.primID,step+1),t-float(step));
+    return BBox3fa(Vec3fa(prim.lower_x,prim.lower_y,prim.lower_z)+offset,Vec3fa(prim.upper_x,prim.upper_y,prim.upper_z)+offset);
+  }
+
+  const unsigned int g_numTimeSegments = 4;
+
+  /* calculates conservative linear bounds of a moving primitive over some time range */
+  void primitiveLinearBounds(const RTCBuildPrimitive* prim, float time0, float time1, RTCLinearBounds* lbounds, void* userPtr)
+  {
+    const RTCBuildPrimitive& prim0 = ((const RTCBuildPrimitive*)userPtr)[prim->primID];
+    BBox3fa bounds = merge(motionBounds(prim0,g_numTimeSegments,time0),motionBounds(prim0,g_numTimeSegments,time1));
+    for (unsigned int i=1; i<g_numTimeSegments; i++) {
+      const float time = float(i)/float(g_numTimeSegments);
+      if (time0 < time && time < time1) bounds.extend(motionBounds(prim0,g_numTimeSegments,time));
+    }
+    *(BBox3fa*) &lbounds->bounds0 = bounds;
+    *(BBox3fa*) &lbounds->bounds1 = bounds;
+  }
+
   struct Node
   {
     virtual float sah() = 0;
@@ -66,6 +95,13 @@ namespace embree
       for (size_t i=0; i<2; i++)
         ((InnerNode*)nodePtr)->bounds[i] = *(const BBox3fa*) bounds[i];
     }
+
+    static void  setLinearBounds (void* nodePtr, const RTCLinearBounds** bounds, const RTCTimeRange* timeRanges, unsigned int numChildren, void* userPtr)
+    {
+      assert(numChildren == 2);
+      for (size_t i=0; i<2; i++)
+        ((InnerNode*)nodePtr)->bounds[i] = merge(*(const BBox3fa*) &bounds[i]->bounds0,*(const BBox3fa*) &bounds[i]->bounds1);
+    }
   };
 
   struct LeafNode : public Node
@@ -88,7 +124,91 @@ namespace embree
     }
   };
 
-  void build(RTCBuildQuality quality, avector<RTCBuildPrimitive>& prims_i, char* cfg, size_t extraSpace = 0)
+  /* calculates the SAH cost of a node of a BVH built with RTC_BUILD_FLAG_FLAT_NODES */
+  float flatSAH(const RTCFlatBVHNode* nodes, unsigned int index)
+  {
+    const RTCFlatBVHNode& node = nodes[index];
+    if (node.count & RTC_FLAT_BVH_LEAF_FLAG)
+      return 1.0f;
+
+    float sah = 0.0f;
+    for (unsigned int i=0; i<node.count; i++)
+      sah += area(*(const BBox3fa*)&nodes[node.offset+i])*flatSAH(nodes,node.offset+i);
+    return 1.0f + sah/area(*(const BBox3fa*)&node);
+  }
+
+  /* returns the number of primitives below a node of a flat BVH and checks that the node bounds contain them */
+  size_t checkFlatBVH(const RTCFlatBVHNode* nodes, const RTCBuildPrimitive* prims, unsigned int index)
+  {
+    const RTCFlatBVHNode& node = nodes[index];
+    const BBox3fa bounds = *(const BBox3fa*)&node;
+    if (node.count & RTC_FLAT_BVH_LEAF_FLAG)
+    {
+      const unsigned int count = node.count & ~RTC_FLAT_BVH_LEAF_FLAG;
+      for (unsigned int i=0; i<count; i++)
+        if (!subset(*(const BBox3fa*)&prims[node.offset+i],bounds)) throw std::runtime_error("leaf does not bound its primitives");
+      return count;
+    }
+
+    size_t count = 0;
+    for (unsigned int i=0; i<node.count; i++) {
+      if (!subset(*(const BBox3fa*)&nodes[node.offset+i],bounds)) throw std::runtime_error("node does not bound its children");
+      count += checkFlatBVH(nodes,prims,node.offset+i);
+    }
+    return count;
+  }
+
+  void update(avector<RTCBuildPrimitive>& prims, char* cfg)
+  {
+    RTCBVH bvh = rtcNewBVH(g_device);
+
+    RTCBuildArguments arguments = rtcDefaultBuildArguments();
+    arguments.byteSize = sizeof(arguments);
+    arguments.buildFlags = (RTCBuildFlags) (RTC_BUILD_FLAG_DYNAMIC | RTC_BUILD_FLAG_FLAT_NODES | RTC_BUILD_FLAG_INCREMENTAL);
+    arguments.buildQuality = RTC_BUILD_QUALITY_MEDIUM;
+    arguments.maxBranchingFactor = 2;
+    arguments.maxDepth = 1024;
+    arguments.minLeafSize = 1;
+    arguments.maxLeafSize = 1;
+    arguments.bvh = bvh;
+    arguments.primitives = prims.data();
+    arguments.primitiveCount = prims.size();
+    arguments.primitiveArrayCapacity = prims.size();
+
+    double t0 = getSeconds();
+    rtcBuildBVH(&arguments);
+    double t1 = getSeconds();
+    std::cout << "initial build over " << prims.size() << " primitives, " << 1000.0f*(t1-t0) << "ms, sah = " << flatSAH(rtcGetBVHNodes(bvh),0) << std::endl;
+
+    /* move 2% of the primitives in each iteration */
+    const size_t numMoved = prims.size()/50;
+    avector<RTCBuildPrimitive> moved(numMoved);
+    for (size_t i=0; i<10; i++)
+    {
+      for (size_t j=0; j<numMoved; j++) {
+        moved[j] = prims[(50*j+i) % prims.size()];
+        const float dx = 20.0f*(float(drand48())-0.5f);
+        moved[j].lower_x += dx; moved[j].upper_x += dx;
+      }
+
+      t0 = getSeconds();
+      rtcRemoveBVHPrimitives(bvh,moved.data(),moved.size());
+      rtcInsertBVHPrimitives(bvh,moved.data(),moved.size());
+      t1 = getSeconds();
+      for (size_t j=0; j<numMoved; j++) prims[(50*j+i) % prims.size()] = moved[j];
+
+      const RTCFlatBVHNode* nodes = rtcGetBVHNodes(bvh);
+      const size_t count = checkFlatBVH(nodes,rtcGetBVHPrimitives(bvh),0);
+      if (count != prims.size()) throw std::runtime_error("BVH lost primitives during updates");
+      std::cout << "iteration " << i << ": moving " << numMoved << " primitives, " << 1000.0f*(t1-t0) << "ms, sah = " << flatSAH(nodes,0)
+                << ", nodes = " << rtcGetBVHNodeCount(bvh) << " [DONE]" << std::endl;
+    }
+
+    rtcReleaseBVH(bvh);
+  }
+
+  void build(RTCBuildQuality quality, avector<RTCBuildPrimitive>& prims_i, char* cfg, size_t extraSpace = 0, RTCBuildFlags flags = RTC_BUILD_FLAG_NONE,
+             const Vec3fa* vertices = nullptr, unsigned int numTimeSegments = 0)
   {
     rtcSetDeviceMemoryMonitorFunction(g_device,memoryMonitor,nullptr);
 
@@ -101,7 +221,7 @@ namespace embree
     /* settings for BVH build */
     RTCBuildArguments arguments = rtcDefaultBuildArguments();
     arguments.byteSize = sizeof(arguments);
-    arguments.buildFlags = RTC_BUILD_FLAG_DYNAMIC;
+    arguments.buildFlags = (RTCBuildFlags) (RTC_BUILD_FLAG_DYNAMIC | flags);
     arguments.buildQuality = quality;
     arguments.maxBranchingFactor = 2;
     arguments.maxDepth = 1024;
@@ -121,6 +241,21 @@ namespace embree
     arguments.splitPrimitive = splitPrimitive;
     arguments.buildProgress = buildProgress;
     arguments.userPtr = nullptr;
+
+    /* let the builder split the triangles itself */
+    if (vertices) {
+      arguments.splitPrimitive = nullptr;
+      arguments.vertices = (const float*) vertices;
+      arguments.vertexStride = sizeof(Vec3fa);
+    }
+
+    /* build over moving primitives */
+    if (numTimeSegments) {
+      arguments.timeSegmentCount = numTimeSegments;
+      arguments.primitiveLinearBounds = primitiveLinearBounds;
+      arguments.setNodeLinearBounds = InnerNode::setLinearBounds;
+      arguments.userPtr = prims_i.data();
+    }
     
     for (size_t i=0; i<10; i++)
     {
@@ -129,10 +264,14 @@ namespace embree
 
       std::cout << "iteration " << i << ": building BVH over " << prims.size() << " primitives, " << std::flush;
       double t0 = getSeconds();
-      Node* root = (Node*) rtcBuildBVH(&arguments);
+      void* root = rtcBuildBVH(&arguments);
       double t1 = getSeconds();
-      const float sah = root ? root->sah() : 0.0f;
-      std::cout << 1000.0f*(t1-t0) << "ms, " << 1E-6*double(prims.size())/(t1-t0) << " Mprims/s, sah = " << sah << " [DONE]" << std::endl;
+      float sah = 0.0f;
+      if (root && (flags & RTC_BUILD_FLAG_FLAT_NODES)) sah = flatSAH((const RTCFlatBVHNode*)root,0);
+      else if (root) sah = ((Node*)root)->sah();
+      std::cout << 1000.0f*(t1-t0) << "ms, " << 1E-6*double(prims.size())/(t1-t0) << " Mprims/s, sah = " << sah;
+      if (flags & RTC_BUILD_FLAG_FLAT_NODES) std::cout << ", nodes = " << rtcGetBVHNodeCount(bvh);
+      std::cout << " [DONE]" << std::endl;
     }
 
     rtcReleaseBVH(bvh);
@@ -169,11 +308,59 @@ namespace embree
     std::cout << "Low quality BVH build:" << std::endl;
     build(RTC_BUILD_QUALITY_LOW,prims,cfg);
 
+    std::cout << "Low quality BVH build with 64 bit Morton codes:" << std::endl;
+    build(RTC_BUILD_QUALITY_LOW,prims,cfg,0,RTC_BUILD_FLAG_MORTON_64);
+
+    std::cout << "Low quality BVH build into flat nodes:" << std::endl;
+    build(RTC_BUILD_QUALITY_LOW,prims,cfg,0,RTC_BUILD_FLAG_FLAT_NODES);
+
     std::cout << "Normal quality BVH build:" << std::endl;
     build(RTC_BUILD_QUALITY_MEDIUM,prims,cfg);
 
+    std::cout << "Normal quality BVH build into flat nodes:" << std::endl;
+    build(RTC_BUILD_QUALITY_MEDIUM,prims,cfg,0,RTC_BUILD_FLAG_FLAT_NODES);
+
     std::cout << "High quality BVH build:" << std::endl;
     build(RTC_BUILD_QUALITY_HIGH,prims,cfg,extraSpace);
+
+    std::cout << "Incremental updates of a flat BVH:" << std::endl;
+    update(prims,cfg);
+
+    /* let a subset of the primitives move */
+    avector<RTCBuildPrimitive> movingPrims(N/10);
+    for (size_t i=0; i<movingPrims.size(); i++) movingPrims[i] = prims[i];
+    std::cout << "Motion blur BVH build:" << std::endl;
+    build(RTC_BUILD_QUALITY_MEDIUM,movingPrims,cfg,0,RTC_BUILD_FLAG_NONE,nullptr,g_numTimeSegments);
+
+    /* create random long triangles */
+    const size_t numTriangles = 500000;
+    avector<Vec3fa> vertices(3*numTriangles);
+    avector<RTCBuildPrimitive> triangles(numTriangles);
+    for (size_t i=0; i<numTriangles; i++)
+    {
+      const Vec3fa p = 1000.0f*Vec3fa(float(drand48()),float(drand48()),float(drand48()));
+      const Vec3fa d = 100.0f*Vec3fa(float(drand48())-0.5f,float(drand48())-0.5f,float(drand48())-0.5f);
+      vertices[3*i+0] = p;
+      vertices[3*i+1] = p+d;
+      vertices[3*i+2] = p+d+Vec3fa(1.0f);
+
+      BBox3fa b = empty;
+      for (size_t j=0; j<3; j++) b.extend(vertices[3*i+j]);
+      RTCBuildPrimitive& prim = triangles[i];
+      prim.lower_x = b.lower.x; prim.lower_y = b.lower.y; prim.lower_z = b.lower.z;
+      prim.geomID = 0;
+      prim.upper_x = b.upper.x; prim.upper_y = b.upper.y; prim.upper_z = b.upper.z;
+      prim.primID = (unsigned) i;
+    }
+
+    std::cout << "Normal quality BVH build over triangles:" << std::endl;
+    build(RTC_BUILD_QUALITY_MEDIUM,triangles,cfg);
+
+    std::cout << "High quality BVH build over triangles with spatial splits:" << std::endl;
+    build(RTC_BUILD_QUALITY_HIGH,triangles,cfg,numTriangles/2,RTC_BUILD_FLAG_NONE,vertices.data());
+
+    std::cout << "High quality BVH build over triangles with presplits:" << std::endl;
+    build(RTC_BUILD_QUALITY_HIGH,triangles,cfg,numTriangles/2,RTC_BUILD_FLAG_PRESPLITS,vertices.data());
   }
 
   void renderFrameStandard (int* pixels,
@@ -243,6 +243,9 @@ void TutorialBuildBenchmark::registerBenchmark(std::string const& name, int argc
   registerBuildBenchmark(name, BuildBenchType::CREATE_STATIC_STATIC,              argc, argv);
   registerBuildBenchmark(name, BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC, argc, argv);
   registerBuildBenchmark(name, BuildBenchType::CREATE_USER_THREADS_STATIC_STATIC, argc, argv);
+  registerBuildBenchmark(name, BuildBenchType::TRACE_FAST,                        argc, argv);
+  registerBuildBenchmark(name, BuildBenchType::TRACE_ROBUST,                      argc, argv);
+  registerBuildBenchmark(name, BuildBenchType::TRACE_WATERTIGHT,                  argc, argv);
 }
 
 void TutorialBuildBenchmark::postParseCommandLine()
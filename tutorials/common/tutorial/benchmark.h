@@ -22,7 +22,11 @@ enum BuildBenchType {
   CREATE_STATIC_STATIC = 64,
   CREATE_HIGH_QUALITY_STATIC_STATIC = 128,
   CREATE_USER_THREADS_STATIC_STATIC = 256,
-  ALL = 511
+  ALL = 511,
+  TRACE_FAST = 512,
+  TRACE_ROBUST = 1024,
+  TRACE_WATERTIGHT = 2048,
+  TRACE = 3584
 };
 
 static MAYBE_UNUSED BuildBenchType getBuildBenchType(std::string const& str)
@@ -36,6 +40,10 @@ static MAYBE_UNUSED BuildBenchType getBuildBenchType(std::string const& str)
   else if (str == "create_static_static")              return BuildBenchType::CREATE_STATIC_STATIC;
   else if (str == "create_high_quality_static_static") return BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC;
   else if (str == "create_user_threads_static_static") return BuildBenchType::CREATE_USER_THREADS_STATIC_STATIC;
+  else if (str == "trace_fast")                        return BuildBenchType::TRACE_FAST;
+  else if (str == "trace_robust")                      return BuildBenchType::TRACE_ROBUST;
+  else if (str == "trace_watertight")                  return BuildBenchType::TRACE_WATERTIGHT;
+  else if (str == "trace")                             return BuildBenchType::TRACE;
   return BuildBenchType::ALL;
 }
 
@@ -50,6 +58,10 @@ static MAYBE_UNUSED std::string getBuildBenchTypeString(BuildBenchType type)
   else if (type == BuildBenchType::CREATE_STATIC_STATIC)              return "create_static_static";
   else if (type == BuildBenchType::CREATE_HIGH_QUALITY_STATIC_STATIC) return "create_high_quality_static_static";
   else if (type == BuildBenchType::CREATE_USER_THREADS_STATIC_STATIC) return "create_user_threads_static_static";
+  else if (type == BuildBenchType::TRACE_FAST)                        return "trace_fast";
+  else if (type == BuildBenchType::TRACE_ROBUST)                      return "trace_robust";
+  else if (type == BuildBenchType::TRACE_WATERTIGHT)                  return "trace_watertight";
+  else if (type == BuildBenchType::TRACE)                             return "trace";
   return "all";
 }
 
@@ -146,7 +158,7 @@ struct TutorialBuildBenchmark : public TutorialBenchmark
         std::string str = cin->getString();
         buildParams.buildBenchType = getBuildBenchType(str);
         processedCommandLineOptions.push_back("--benchmark_type");
-      }, "--benchmark_type <string>: select which build types to benchmark");
+      }, "--benchmark_type <string>: select which build types to benchmark, the trace, trace_fast, trace_robust, and trace_watertight types measure the ray tracing throughput of the respective triangle intersection modes");
     commandLineParser.registerOption("user_threads", [this] (Ref<ParseStream> cin, const FileName& path) {
         buildParams.userThreads = cin->getInt();
       }, "--user_threads <int>: invokes user thread benchmark with specified number of application provided build threads");
@@ -53,7 +53,8 @@ enum Shader {
   SHADER_CYCLES,
   SHADER_GEOMID,
   SHADER_GEOMID_PRIMID,
-  SHADER_AO
+  SHADER_AO,
+  SHADER_COST
 };
 
 extern "C" RTCDevice g_device;
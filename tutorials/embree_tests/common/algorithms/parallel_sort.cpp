@@ -2,14 +2,18 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "../../../external/catch.hpp"
+#include "../common/tasking/taskscheduler.h"
 #include "../common/algorithms/parallel_sort.h"
+#include "../common/sys/sysinfo.h"
+
+#include <thread>
 
 using namespace embree;
 
 namespace parallel_sort_unit_test {
 
-template<typename Key>
-bool run_sort_test()
+template<typename Key, typename KeyGen>
+bool run_sort_test(const KeyGen& keyGen)
 {
   bool passed = true;
   const size_t M = 10;
@@ -21,7 +25,7 @@ bool run_sort_test()
     std::vector<Key> tmp(N);
     memset(tmp.data(), 0, N * sizeof(Key));
     for (size_t i = 0; i < N; i++)
-      src[i] = uint64_t(rand()) * uint64_t(rand());
+      src[i] = keyGen();
 
     /* calculate checksum */
     Key sum0 = 0;
@@ -49,14 +53,68 @@ bool run_sort_test()
   return passed;
 }
 
+template<typename Key>
+bool run_sort_test()
+{
+  return run_sort_test<Key>([] { return Key(uint64_t(rand()) * uint64_t(rand())); });
+}
+
 TEST_CASE("Test parallel_sort (uint32_t)", "[parallel_sort_uint32_t]")
 {
-  REQUIRE(run_sort_test<uint64_t>());
+  TaskScheduler::create(std::thread::hardware_concurrency(), true, false);
+  REQUIRE(run_sort_test<uint32_t>());
 }
 
 TEST_CASE("Test parallel_sort (uint64_t)", "[parallel_sort_uint64_t]")
 {
+  TaskScheduler::create(std::thread::hardware_concurrency(), true, false);
   REQUIRE(run_sort_test<uint64_t>());
 }
 
+TEST_CASE("Test parallel_sort with identical digits", "[parallel_sort_identical_digits]")
+{
+  TaskScheduler::create(std::thread::hardware_concurrency(), true, false);
+
+  /* passes over identical digits get skipped, which can leave an odd number of passes */
+  REQUIRE(run_sort_test<uint32_t>([] { return uint32_t(7); }));
+  REQUIRE(run_sort_test<uint32_t>([] { return uint32_t(rand() & 0x3ff) << 22; }));
+  REQUIRE(run_sort_test<uint64_t>([] { return uint64_t(rand()) << 40 | 0x12345; }));
+  REQUIRE(run_sort_test<uint64_t>([] { return uint64_t(rand()) * uint64_t(rand()) & 0xffffffff; }));
+}
+
+/* run with "[benchmark]" to measure the throughput of the radix sort */
+template<typename Key, typename KeyGen>
+void run_sort_benchmark(const char* name, const KeyGen& keyGen)
+{
+  for (size_t N = 1000; N <= 16000000; N *= 4)
+  {
+    std::vector<Key> keys(N), src(N), tmp(N);
+    for (size_t i = 0; i < N; i++)
+      keys[i] = keyGen();
+
+    double radix_dt = std::numeric_limits<double>::infinity(), std_dt = radix_dt;
+    for (size_t i = 0; i < 5; i++)
+    {
+      src = keys;
+      double t0 = getSeconds();
+      radix_sort<Key>(src.data(), tmp.data(), N);
+      radix_dt = std::min(radix_dt, getSeconds() - t0);
+
+      src = keys;
+      t0 = getSeconds();
+      std::sort(src.begin(), src.end());
+      std_dt = std::min(std_dt, getSeconds() - t0);
+    }
+    printf("%s N = %9zu: radix_sort %8.2f Mkeys/s, std::sort %8.2f Mkeys/s\n", name, N, 1E-6 * N / radix_dt, 1E-6 * N / std_dt);
+  }
+}
+
+TEST_CASE("Benchmark parallel_sort", "[.benchmark]")
+{
+  TaskScheduler::create(std::thread::hardware_concurrency(), true, false);
+  run_sort_benchmark<uint32_t>("uint32_t (30 bits)", [] { return uint32_t(uint64_t(rand()) * uint64_t(rand())) & 0x3fffffff; });
+  run_sort_benchmark<uint64_t>("uint64_t (63 bits)", [] { return (uint64_t(rand()) << 42 ^ uint64_t(rand()) << 21 ^ uint64_t(rand())) & 0x7fffffffffffffff; });
+  run_sort_benchmark<uint64_t>("uint64_t (32 bits)", [] { return uint64_t(rand()) * uint64_t(rand()) & 0xffffffff; });
+}
+
 }
@@ -0,0 +1,93 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../../external/catch.hpp"
+#include "../common/tasking/taskscheduler.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace embree;
+
+namespace taskscheduler_unit_test {
+
+#if defined(TASKING_INTERNAL) && !defined(TASKING_TBB)
+
+/* spawns more tasks than fit into the first block of the task stack */
+TEST_CASE("Test task stack growth", "[taskscheduler]")
+{
+  TaskScheduler::create(std::thread::hardware_concurrency(), true, false);
+
+  const size_t N = 4*TaskScheduler::TASK_BLOCK_SIZE+17;
+  std::atomic<size_t> count(0);
+  TaskScheduler::TaskGroupContext context;
+  TaskScheduler::spawn([&] ()
+  {
+    for (size_t i=0; i<N; i++)
+      TaskScheduler::spawn([&] () { count++; },&context);
+    TaskScheduler::wait();
+  },&context);
+  TaskScheduler::wait();
+
+  REQUIRE(count == N);
+}
+
+/* spawns closures that do not fit into the first block of the closure stack */
+TEST_CASE("Test closure stack growth", "[taskscheduler]")
+{
+  TaskScheduler::create(std::thread::hardware_concurrency(), true, false);
+
+  struct Payload { char data[64*1024]; };
+  const size_t N = 4*TaskScheduler::CLOSURE_BLOCK_SIZE/sizeof(Payload);
+  std::atomic<size_t> sum(0);
+  TaskScheduler::TaskGroupContext context;
+  TaskScheduler::spawn([&] ()
+  {
+    for (size_t i=0; i<N; i++) {
+      Payload payload;
+      payload.data[0] = 1;
+      payload.data[sizeof(payload.data)-1] = 2;
+      TaskScheduler::spawn([payload,&sum] () { sum += payload.data[0]+payload.data[sizeof(payload.data)-1]; },&context);
+    }
+    TaskScheduler::wait();
+  },&context);
+  TaskScheduler::wait();
+
+  REQUIRE(sum == 3*N);
+}
+
+/* a background scheduler and an interactive scheduler both complete their work */
+TEST_CASE("Test priority lanes", "[taskscheduler]")
+{
+  TaskScheduler::create(std::thread::hardware_concurrency(), true, false);
+
+  const size_t N = 100000;
+  std::atomic<size_t> count[TaskScheduler::NUM_PRIORITIES];
+  Ref<TaskScheduler> schedulers[TaskScheduler::NUM_PRIORITIES];
+  for (size_t p=0; p<TaskScheduler::NUM_PRIORITIES; p++) {
+    count[p] = 0;
+    schedulers[p] = new TaskScheduler(TaskScheduler::Priority(p));
+  }
+
+  auto build = [&] (size_t p)
+  {
+    TaskScheduler::TaskGroupContext context;
+    schedulers[p]->spawn_root([&] () {
+      TaskScheduler::spawn(size_t(0),N,size_t(16),[&] (const range<size_t>& r) {
+        count[p] += r.size();
+      },&context);
+      TaskScheduler::wait();
+    },&context);
+  };
+
+  std::thread background([&] () { build(TaskScheduler::PRIORITY_BACKGROUND); });
+  build(TaskScheduler::PRIORITY_INTERACTIVE);
+  background.join();
+
+  for (size_t p=0; p<TaskScheduler::NUM_PRIORITIES; p++)
+    REQUIRE(count[p] == N);
+}
+
+#endif
+
+}
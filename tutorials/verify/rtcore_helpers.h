@@ -659,7 +659,8 @@ namespace embree
     else ret += "Static";
     if (scene_flags & RTC_SCENE_FLAG_COMPACT) ret += "Compact";
     if (scene_flags & RTC_SCENE_FLAG_ROBUST ) ret += "Robust";
-    if (!(scene_flags & RTC_SCENE_FLAG_COMPACT) && !(scene_flags & RTC_SCENE_FLAG_ROBUST)) ret += "Fast"; 
+    if (scene_flags & RTC_SCENE_FLAG_WATERTIGHT) ret += "Watertight";
+    if (!(scene_flags & RTC_SCENE_FLAG_COMPACT) && !(scene_flags & RTC_SCENE_FLAG_ROBUST) && !(scene_flags & RTC_SCENE_FLAG_WATERTIGHT)) ret += "Fast"; 
     return ret;
   }
   
@@ -1206,6 +1206,987 @@ namespace embree
     }
   };
 
+  struct RayDistributionHintTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality; 
+
+    RayDistributionHintTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+    
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* sample rays of a camera looking at the sphere */
+      RTCRayHit samples[64];
+      for (size_t i=0; i<64; i++) {
+        const Vec3fa dir(0.5f*random_float()-0.25f,0.5f*random_float()-0.25f,1.0f);
+        samples[i] = makeRay(Vec3fa(0.0f,0.0f,-3.0f),dir);
+      }
+
+      const Vec3fa center = zero;
+      const float radius = 1.0f;
+      VerifyScene scene0(device,sflags);
+      scene0.addGeometry(quality,SceneGraph::createTriangleSphere(center,radius,50));
+      rtcCommitScene (scene0);
+      AssertNoError(device);
+
+      VerifyScene scene1(device,sflags);
+      scene1.addGeometry(quality,SceneGraph::createTriangleSphere(center,radius,50));
+      rtcSetSceneRayDistributionHint(scene1,&samples[0].ray,64,0.5f);
+      AssertNoError(device);
+      rtcCommitScene (scene1);
+      AssertNoError(device);
+
+      /* the hint must not change intersection results */
+      for (size_t i=0; i<256; i++)
+      {
+        const Vec3fa org = 4.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(2.0f);
+        const Vec3fa dir = center-org;
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (abs(ray0.ray.tfar-ray1.ray.tfar) > 16.0f*float(ulp)*ray0.ray.tfar) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* invalid arguments */
+      rtcSetSceneRayDistributionHint(scene1,nullptr,64,0.5f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcSetSceneRayDistributionHint(scene1,&samples[0].ray,64,2.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      /* removing the hint */
+      rtcSetSceneRayDistributionHint(scene1,nullptr,0,0.0f);
+      rtcCommitScene (scene1);
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct CommitStatisticsTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    CommitStatisticsTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCSceneCommitStatistics stats;
+
+      /* statistics have to get enabled through the device configuration */
+      {
+        RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcGetDeviceError(device));
+        VerifyScene scene(device,sflags);
+        rtcCommitScene (scene);
+        AssertNoError(device);
+        rtcGetSceneCommitStatistics(scene,&stats);
+        AssertError(device,RTC_ERROR_INVALID_OPERATION);
+      }
+
+      RTCDeviceRef device = rtcNewDevice((cfg+",commit_statistics=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,sflags);
+
+      const Vec3fa center = zero;
+      const float radius = 1.0f;
+      const Vec3fa dx(1,0,0);
+      const Vec3fa dy(0,1,0);
+      unsigned int geomID = scene.addGeometry(RTC_BUILD_QUALITY_REFIT,SceneGraph::createTriangleSphere(center,radius,50));
+      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadSphere(center,radius,50));
+      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTriangleSphere(center,radius,50)->set_motion_vector(random_motion_vector(1.0f)));
+      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createHairyPlane(RandomSampler_getInt(sampler),center,dx,dy,0.1f,0.01f,100,SceneGraph::FLAT_CURVE));
+      rtcCommitScene (scene);
+      rtcGetSceneCommitStatistics(scene,&stats);
+      AssertNoError(device);
+
+      /* every phase reports its place in the hierarchy */
+      for (int i=0; i<RTC_BUILD_PHASE_COUNT; i++)
+      {
+        const RTCBuildPhase phase = (RTCBuildPhase) i;
+        const bool nested = phase == RTC_BUILD_PHASE_LEAF_CREATION || phase == RTC_BUILD_PHASE_ALLOCATOR_WAIT;
+        if (stats.phases[i].parent != (nested ? RTC_BUILD_PHASE_BINNING : RTC_BUILD_PHASE_COMMIT)) return VerifyApplication::FAILED;
+        if (!(stats.phases[i].time >= 0.0)) return VerifyApplication::FAILED;
+        if (stats.phases[i].count == 0 && stats.phases[i].time != 0.0) return VerifyApplication::FAILED;
+      }
+
+      const bool twoLevel = sflags.qflags == RTC_BUILD_QUALITY_LOW; // low quality scenes build per-geometry BVHs
+      if (stats.phases[RTC_BUILD_PHASE_COMMIT].count != 1) return VerifyApplication::FAILED;
+      if (stats.phases[RTC_BUILD_PHASE_COMMIT].numPrimitives == 0) return VerifyApplication::FAILED;
+      if (stats.phases[RTC_BUILD_PHASE_PRIMREF_GENERATION].count == 0) return VerifyApplication::FAILED;
+      if (stats.phases[RTC_BUILD_PHASE_BINNING].count == 0) return VerifyApplication::FAILED;
+      if (stats.phases[RTC_BUILD_PHASE_BINNING].numPrimitives == 0) return VerifyApplication::FAILED;
+      if (stats.phases[RTC_BUILD_PHASE_LEAF_CREATION].count == 0) return VerifyApplication::FAILED;
+      if ((stats.phases[RTC_BUILD_PHASE_TOP_LEVEL_BUILD].count != 0) != twoLevel) return VerifyApplication::FAILED;
+      if (stats.phases[RTC_BUILD_PHASE_REFIT].count != 0) return VerifyApplication::FAILED;
+
+      /* committing an unmodified scene keeps the statistics */
+      rtcCommitScene (scene);
+      rtcGetSceneCommitStatistics(scene,&stats);
+      AssertNoError(device);
+      if (stats.phases[RTC_BUILD_PHASE_COMMIT].count != 1) return VerifyApplication::FAILED;
+
+      /* moving vertices of a refit geometry of a two-level build only refits its BVH */
+      if (twoLevel)
+      {
+        RTCGeometry geom = rtcGetGeometry(scene,geomID);
+        rtcUpdateGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0);
+        rtcCommitGeometry(geom);
+        rtcCommitScene (scene);
+        rtcGetSceneCommitStatistics(scene,&stats);
+        AssertNoError(device);
+        if (stats.phases[RTC_BUILD_PHASE_COMMIT].count != 1) return VerifyApplication::FAILED;
+        if (stats.phases[RTC_BUILD_PHASE_REFIT].count != 1) return VerifyApplication::FAILED;
+      }
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TraversalStatisticsTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    TraversalStatisticsTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static bool valid(const RTCTraversalCounter& counter, size_t numRays)
+    {
+      size_t sum = 0;
+      for (size_t i=0; i<RTC_TRAVERSAL_HISTOGRAM_BINS; i++) sum += counter.histogram[i];
+      if (sum != numRays) return false;
+      if (counter.max > counter.total) return false;
+      return numRays == 0 || counter.total <= numRays*counter.max;
+    }
+
+    static bool valid(const RTCTraversalStatistics& stats) {
+      return valid(stats.nodes,stats.numRays) && valid(stats.leaves,stats.numRays) && valid(stats.primitives,stats.numRays);
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCTraversalStatistics stats;
+
+      /* statistics have to get enabled through the device configuration */
+      {
+        RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcGetDeviceError(device));
+        VerifyScene scene(device,sflags);
+        rtcCommitScene (scene);
+        AssertNoError(device);
+        rtcGetSceneTraversalStatistics(scene,RTC_INVALID_GEOMETRY_ID,&stats);
+        AssertError(device,RTC_ERROR_INVALID_OPERATION);
+      }
+
+      RTCDeviceRef device = rtcNewDevice((cfg+",traversal_statistics=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* a triangle sphere next to an instanced quad sphere */
+      VerifyScene child(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      child.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadSphere(Vec3fa(0.0f),1.0f,50));
+      rtcCommitScene (child);
+
+      VerifyScene scene(device,sflags);
+      const unsigned int geomID0 = scene.addGeometry(sflags.qflags,SceneGraph::createTriangleSphere(Vec3fa(-1.5f,0.0f,0.0f),1.0f,50));
+      RTCGeometry inst = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+      const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(1.5f,0.0f,0.0f));
+      rtcSetGeometryInstancedScene(inst,child);
+      rtcSetGeometryTransform(inst,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,&xfm.l.vx.x);
+      rtcCommitGeometry(inst);
+      const unsigned int geomID1 = rtcAttachGeometry(scene,inst);
+      rtcReleaseGeometry(inst);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* every single ray gets sampled */
+      const size_t numRays = 256;
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(4.0f*random_float()-2.0f,2.0f*random_float()-1.0f,-4.0f);
+        RTCRayHit ray = makeRay(org,Vec3fa(0,0,1));
+        if (i%2) rtcIntersect1(scene,&ray);
+        else     rtcOccluded1(scene,&ray.ray);
+      }
+      rtcGetSceneTraversalStatistics(scene,RTC_INVALID_GEOMETRY_ID,&stats);
+      AssertNoError(device);
+      if (stats.numRays != numRays) return VerifyApplication::FAILED;
+      if (!valid(stats)) return VerifyApplication::FAILED;
+      if (stats.nodes.total == 0 || stats.leaves.total == 0) return VerifyApplication::FAILED;
+      if (stats.primitives.total < stats.leaves.total) return VerifyApplication::FAILED;
+
+      /* all primitives store their geometry, instanced scenes count for the instance */
+      RTCTraversalStatistics stats0, stats1;
+      rtcGetSceneTraversalStatistics(scene,geomID0,&stats0);
+      rtcGetSceneTraversalStatistics(scene,geomID1,&stats1);
+      AssertNoError(device);
+      if (!valid(stats0) || !valid(stats1)) return VerifyApplication::FAILED;
+      if (stats0.numRays == 0 || stats0.numRays > numRays) return VerifyApplication::FAILED;
+      if (stats1.numRays == 0 || stats1.numRays > numRays) return VerifyApplication::FAILED;
+      if (stats0.primitives.total + stats1.primitives.total != stats.primitives.total) return VerifyApplication::FAILED;
+      if (stats1.nodes.total == 0 || stats1.nodes.total >= stats.nodes.total) return VerifyApplication::FAILED;
+
+      /* invalid geometry */
+      rtcGetSceneTraversalStatistics(scene,geomID1+1,&stats);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      /* packets do not get sampled */
+      RTCRayHit4 ray4;
+      for (size_t i=0; i<4; i++) setRay(ray4,i,makeRay(Vec3fa(-1.5f,0.0f,-4.0f),Vec3fa(0,0,1)));
+      __aligned(16) int valid4[4] = { -1,-1,-1,-1 };
+      rtcIntersect4(valid4,scene,&ray4);
+      rtcGetSceneTraversalStatistics(scene,RTC_INVALID_GEOMETRY_ID,&stats);
+      if (stats.numRays != numRays) return VerifyApplication::FAILED;
+
+      rtcResetSceneTraversalStatistics(scene);
+      rtcGetSceneTraversalStatistics(scene,RTC_INVALID_GEOMETRY_ID,&stats);
+      rtcGetSceneTraversalStatistics(scene,geomID1,&stats1);
+      AssertNoError(device);
+      if (stats.numRays != 0 || stats.nodes.total != 0 || stats1.numRays != 0) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct RayCostTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    RayCostTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",traversal_statistics=1";
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      VerifyScene scene(device,sflags);
+      scene.addGeometry(sflags.qflags,SceneGraph::createTriangleSphere(Vec3fa(0.0f),1.0f,50));
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      RTCRayCost cost;
+      RTCIntersectArguments iargs;
+      rtcInitIntersectArguments(&iargs);
+      iargs.cost = &cost;
+      RTCOccludedArguments oargs;
+      rtcInitOccludedArguments(&oargs);
+      oargs.cost = &cost;
+
+      /* a ray missing the scene bounds visits no leaves */
+      RTCRayHit ray = makeRay(Vec3fa(4.0f,4.0f,-4.0f),Vec3fa(0,0,1));
+      rtcIntersect1(scene,&ray,&iargs);
+      if (ray.hit.geomID != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+      if (cost.leaves != 0 || cost.primitives != 0) return VerifyApplication::FAILED;
+
+      /* the cost of each ray adds up to the statistics of the scene */
+      rtcResetSceneTraversalStatistics(scene);
+      size_t nodes = 0, leaves = 0, primitives = 0;
+      for (size_t i=0; i<64; i++)
+      {
+        const Vec3fa org(1.4f*random_float()-0.7f,1.4f*random_float()-0.7f,-4.0f);
+        RTCRayHit ray = makeRay(org,Vec3fa(0,0,1));
+        cost.nodes = cost.leaves = cost.primitives = -1;
+        if (i%2) {
+          rtcIntersect1(scene,&ray,&iargs);
+          if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+        } else {
+          rtcOccluded1(scene,&ray.ray,&oargs);
+          if (ray.ray.tfar >= 0.0f) return VerifyApplication::FAILED;
+        }
+        if (cost.nodes == 0 || cost.leaves == 0 || cost.primitives == 0) return VerifyApplication::FAILED;
+        nodes += cost.nodes; leaves += cost.leaves; primitives += cost.primitives;
+      }
+      RTCTraversalStatistics stats;
+      rtcGetSceneTraversalStatistics(scene,RTC_INVALID_GEOMETRY_ID,&stats);
+      AssertNoError(device);
+      if (stats.nodes.total != nodes || stats.leaves.total != leaves || stats.primitives.total != primitives)
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TreeletRestructureTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality; 
+
+    TreeletRestructureTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+    
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg0 = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg1 = cfg0 + ",treelet_restructure=2";
+      RTCDeviceRef device0 = rtcNewDevice(cfg0.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice(cfg1.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      const Vec3fa center = zero;
+      const float radius = 1.0f;
+      const Vec3fa p(-1,-1,0);
+      const Vec3fa dx(2,0,0);
+      const Vec3fa dy(0,2,0);
+      VerifyScene scene0(device0,sflags);
+      scene0.addGeometry(quality,SceneGraph::createTriangleSphere(center,radius,50));
+      scene0.addGeometry(quality,SceneGraph::createQuadPlane(p,dx,dy,40,40));
+      rtcCommitScene (scene0);
+      AssertNoError(device0);
+
+      VerifyScene scene1(device1,sflags);
+      scene1.addGeometry(quality,SceneGraph::createTriangleSphere(center,radius,50));
+      scene1.addGeometry(quality,SceneGraph::createQuadPlane(p,dx,dy,40,40));
+      rtcCommitScene (scene1);
+      AssertNoError(device1);
+
+      /* restructuring must not change intersection results */
+      for (size_t i=0; i<256; i++)
+      {
+        const Vec3fa org = 4.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(2.0f);
+        const Vec3fa dir = 0.5f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(0.25f)-org;
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (abs(ray0.ray.tfar-ray1.ray.tfar) > 16.0f*float(ulp)*ray0.ray.tfar) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct IntersectionCostTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality; 
+
+    IntersectionCostTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+    
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const float radius = 1.0f;
+      const Vec3fa centers[3] = { Vec3fa(-1.5f,0.0f,0.0f), Vec3fa(0.0f,0.0f,0.0f), Vec3fa(1.5f,0.0f,0.0f) };
+      VerifyScene scene0(device,sflags);
+      VerifyScene scene1(device,sflags);
+      for (size_t i=0; i<3; i++) {
+        scene0.addGeometry(quality,SceneGraph::createTriangleSphere(centers[i],radius,20));
+        scene1.addGeometry(quality,SceneGraph::createTriangleSphere(centers[i],radius,20));
+      }
+      rtcCommitScene (scene0);
+      AssertNoError(device);
+
+      /* make the center sphere expensive to intersect */
+      RTCGeometry geom = rtcGetGeometry(scene1,1);
+      rtcSetGeometryIntersectionCost(geom,32.0f);
+      AssertNoError(device);
+      rtcCommitGeometry(geom);
+      rtcCommitScene (scene1);
+      AssertNoError(device);
+
+      /* intersection costs must not change intersection results */
+      for (size_t i=0; i<256; i++)
+      {
+        const Vec3fa org = 6.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(3.0f);
+        const Vec3fa dir = centers[i%3]-org;
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scene0,&ray0);
+        rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (abs(ray0.ray.tfar-ray1.ray.tfar) > 16.0f*float(ulp)*ray0.ray.tfar) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* invalid arguments */
+      rtcSetGeometryIntersectionCost(geom,0.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcSetGeometryIntersectionCost(geom,-1.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct InstanceOptimizationTest : public VerifyApplication::IntersectTest
+  {
+    std::string config;
+    SceneFlags sflags;
+
+    InstanceOptimizationTest (std::string name, int isa, std::string config, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), config(config), sflags(sflags) {}
+
+    static void addInstances(RTCDevice device, RTCScene scene, RTCScene child)
+    {
+      /* rotated and non-uniformly scaled instances of the prototype */
+      for (int i=0; i<16; i++)
+      {
+        const Vec3fa P(float(i%4)-1.5f,float(i/4)-1.5f,0.0f);
+        const AffineSpace3fa xfm = AffineSpace3fa::translate(P)*AffineSpace3fa::rotate(Vec3fa(1,2,3),0.3f*float(i))*AffineSpace3fa::scale(Vec3fa(0.2f,0.3f+0.01f*float(i),0.4f));
+        RTCGeometry inst = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(inst,child);
+        rtcSetGeometryTransform(inst,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,&xfm.l.vx.x);
+        rtcCommitGeometry(inst);
+        rtcAttachGeometry(scene,inst);
+        rtcReleaseGeometry(inst);
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+","+config).c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      /* small prototype that is also eligible for unrolling */
+      Ref<SceneGraph::Node> sphere = SceneGraph::createTriangleSphere(Vec3fa(0.0f),1.0f,4);
+      VerifyScene child0(device0,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      VerifyScene child1(device1,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      child0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+      child1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+      rtcCommitScene(child0);
+      rtcCommitScene(child1);
+
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      addInstances(device0,scene0,child0);
+      addInstances(device1,scene1,child1);
+      rtcCommitScene(scene0);
+      rtcCommitScene(scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* optimized instances have to report the same hits as regular instances */
+      bool passed = true;
+      const size_t numRays = 256;
+      RTCRayHit rays0[numRays];
+      RTCRayHit rays1[numRays];
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org = Vec3fa(4.0f*random_float()-2.0f,4.0f*random_float()-2.0f,-4.0f);
+        const Vec3fa dir = Vec3fa(0.2f*random_float()-0.1f,0.2f*random_float()-0.1f,1.0f);
+        rays0[i] = rays1[i] = makeRay(org,dir);
+      }
+      IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+      IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const RTCRayHit& ray0 = rays0[i];
+        const RTCRayHit& ray1 = rays1[i];
+        const float eps = 1E-3f;
+        if (ivariant & VARIANT_INTERSECT)
+        {
+          passed &= ray0.hit.instID[0] == ray1.hit.instID[0];
+          passed &= ray0.hit.geomID == ray1.hit.geomID;
+          passed &= ray0.hit.primID == ray1.hit.primID;
+          if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+          passed &= abs(ray0.ray.tfar-ray1.ray.tfar) < eps*ray0.ray.tfar;
+          passed &= abs(ray0.hit.u-ray1.hit.u) < eps && abs(ray0.hit.v-ray1.hit.v) < eps;
+          const Vec3fa Ng0(ray0.hit.Ng_x,ray0.hit.Ng_y,ray0.hit.Ng_z);
+          const Vec3fa Ng1(ray1.hit.Ng_x,ray1.hit.Ng_y,ray1.hit.Ng_z);
+          passed &= length(Ng0-Ng1) < eps*length(Ng0);
+        }
+        else
+          passed &= ray0.ray.tfar == ray1.ray.tfar;
+      }
+
+      AssertNoError(device0);
+      AssertNoError(device1);
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct CurveLODTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    CurveLODTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* parallel curves along the x axis */
+      const unsigned int numCurves = 16;
+      const float radius = 0.05f;
+      VerifyScene scene(device,sflags);
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE);
+      Vec3ff* vertices = (Vec3ff*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT4,sizeof(Vec3ff),4*numCurves);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT,sizeof(unsigned int),numCurves);
+      for (unsigned int i=0; i<numCurves; i++) {
+        for (unsigned int j=0; j<4; j++)
+          vertices[4*i+j] = Vec3ff(float(j)/3.0f*2.0f-1.0f,0.5f*float(i),0.0f,radius);
+        indices[i] = 4*i;
+      }
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* rays towards the curve axes and rays between the curves */
+      const size_t numRays = 256;
+      RTCRayHit rays0[numRays];
+      RTCRayHit rays1[numRays];
+      RTCRayHit rays2[numRays];
+      for (size_t i=0; i<numRays; i++)
+      {
+        const float x = 1.6f*random_float()-0.8f;
+        const float y = 0.5f*float(i%numCurves) + ((i/numCurves)%2 ? 0.25f : 0.0f);
+        const Vec3fa org(0.0f,0.0f,10.0f);
+        rays0[i] = rays1[i] = rays2[i] = makeRay(org,Vec3fa(x,y,0.0f)-org);
+      }
+
+      /* distant curves below the footprint get intersected as flat curves */
+      RTCIntersectArguments args0;
+      rtcInitIntersectArguments(&args0);
+      RTCIntersectArguments args1;
+      rtcInitIntersectArguments(&args1);
+      args1.curveLODDistanceFactor = 1E-4f;
+      RTCIntersectArguments args2;
+      rtcInitIntersectArguments(&args2);
+      args2.curveLODDistanceFactor = 0.1f;
+      IntersectWithMode(imode,ivariant,scene,rays0,numRays,&args0);
+      IntersectWithMode(imode,ivariant,scene,rays1,numRays,&args1);
+      IntersectWithMode(imode,ivariant,scene,rays2,numRays,&args2);
+      AssertNoError(device);
+
+      bool passed = true;
+      size_t numFlatHits = 0;
+      for (size_t i=0; i<numRays; i++)
+      {
+        const RTCRayHit& ray0 = rays0[i];
+        const RTCRayHit& ray1 = rays1[i];
+        const RTCRayHit& ray2 = rays2[i];
+        const bool between = (i/numCurves)%2;
+        passed &= ray0.ray.tfar == ray1.ray.tfar;
+        if (ivariant & VARIANT_INTERSECT)
+        {
+          passed &= ray0.hit.primID == ray1.hit.primID;
+          passed &= ray0.hit.primID == ray2.hit.primID;
+          passed &= between == (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID);
+          if (between) continue;
+          passed &= abs(ray0.ray.tfar-ray2.ray.tfar) < 2.0f*radius;
+          numFlatHits += ray0.ray.tfar != ray2.ray.tfar;
+        }
+        else
+        {
+          passed &= ray0.ray.tfar == ray2.ray.tfar;
+          passed &= between == (ray0.ray.tfar != float(neg_inf));
+        }
+      }
+
+      /* the flat curves are hit at the curve center */
+      if (ivariant & VARIANT_INTERSECT)
+        passed &= numFlatHits > 0;
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct HairSubdivisionTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    HairSubdivisionTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* strongly bent curve segments with control points cp(i,0..3) */
+    static Vec3ff controlPoint(unsigned int i, unsigned int j)
+    {
+      const float x[4] = { -1.0f, -0.3f, 0.3f, 1.0f };
+      const float y[4] = {  0.0f,  1.5f,-1.5f, 0.0f };
+      return Vec3ff(x[j],y[j]+0.8f*float(i),0.3f*float(i),0.1f);
+    }
+
+    static Vec3fa center(RTCGeometryType type, unsigned int i, float u)
+    {
+      float w[4];
+      const float t0 = 1.0f-u, t1 = u;
+      if (type == RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE) {
+        w[0] = t0*t0*t0; w[1] = 3.0f*t0*t0*t1; w[2] = 3.0f*t0*t1*t1; w[3] = t1*t1*t1;
+      } else {
+        w[0] = t0*t0*t0/6.0f; w[1] = (4.0f-6.0f*t1*t1+3.0f*t1*t1*t1)/6.0f; w[2] = (4.0f-6.0f*t0*t0+3.0f*t0*t0*t0)/6.0f; w[3] = t1*t1*t1/6.0f;
+      }
+      Vec3fa p(0.0f);
+      for (unsigned int j=0; j<4; j++) p += w[j]*Vec3fa(controlPoint(i,j));
+      return p;
+    }
+
+    static void addCurves(RTCDevice device, RTCScene scene, RTCGeometryType type, unsigned int numCurves)
+    {
+      RTCGeometry geom = rtcNewGeometry(device,type);
+      Vec3ff* vertices = (Vec3ff*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT4,sizeof(Vec3ff),4*numCurves);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT,sizeof(unsigned int),numCurves);
+      for (unsigned int i=0; i<numCurves; i++) {
+        for (unsigned int j=0; j<4; j++) vertices[4*i+j] = controlPoint(i,j);
+        indices[i] = 4*i;
+      }
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",hair_subdivision_angle=10").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      const unsigned int numCurves = 8;
+      const RTCGeometryType types[2] = { RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE, RTC_GEOMETRY_TYPE_ROUND_BSPLINE_CURVE };
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      for (auto type : types) {
+        addCurves(device0,scene0,type,numCurves);
+        addCurves(device1,scene1,type,numCurves);
+      }
+      rtcCommitScene(scene0);
+      rtcCommitScene(scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* rays towards random points on the curve centers */
+      const size_t numRays = 256;
+      RTCRayHit rays0[numRays];
+      RTCRayHit rays1[numRays];
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa p = center(types[i%2],(unsigned int)((i/2)%numCurves),random_float());
+        const Vec3fa org = p + Vec3fa(0.5f*random_float()-0.25f,0.5f*random_float()-0.25f,10.0f);
+        rays0[i] = rays1[i] = makeRay(org,p-org);
+      }
+      IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+      IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* sub-segments report the hits of the original curve segments */
+      bool passed = true;
+      for (size_t i=0; i<numRays; i++)
+      {
+        const RTCRayHit& ray0 = rays0[i];
+        const RTCRayHit& ray1 = rays1[i];
+        if (ivariant & VARIANT_INTERSECT)
+        {
+          passed &= ray0.hit.geomID != RTC_INVALID_GEOMETRY_ID;
+          passed &= ray0.hit.geomID == ray1.hit.geomID;
+          passed &= ray0.hit.primID == ray1.hit.primID;
+          passed &= abs(ray0.ray.tfar-ray1.ray.tfar) < 1E-3f;
+          passed &= abs(ray0.hit.u-ray1.hit.u) < 1E-3f;
+        }
+        else
+        {
+          passed &= ray0.ray.tfar == float(neg_inf);
+          passed &= ray1.ray.tfar == float(neg_inf);
+        }
+      }
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct IntersectMultiTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    IntersectMultiTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* stack of triangle, quad, and grid planes at z = 0,1,2,... */
+      const unsigned int numPlanes = 9;
+      VerifyScene scene(device,sflags);
+      unsigned int geomIDs[numPlanes];
+      for (unsigned int i=0; i<numPlanes; i++)
+      {
+        const Vec3fa p(-1.0f,-1.0f,float(i));
+        const Vec3fa dx(2.0f,0.0f,0.0f);
+        const Vec3fa dy(0.0f,2.0f,0.0f);
+        Ref<SceneGraph::Node> plane;
+        if      (i%3 == 0) plane = SceneGraph::createTrianglePlane(p,dx,dy,4,4);
+        else if (i%3 == 1) plane = SceneGraph::createQuadPlane(p,dx,dy,4,4);
+        else               plane = SceneGraph::createGridPlane(p,dx,dy,4,4);
+        geomIDs[i] = scene.addGeometry(sflags.qflags,plane);
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      bool passed = true;
+      const unsigned int maxHits[4] = { 1, 3, numPlanes, 16 };
+      for (size_t i=0; i<256; i++)
+      {
+        const unsigned int k = maxHits[i%4];
+        const Vec3fa org(1.8f*random_float()-0.9f,1.8f*random_float()-0.9f,-1.0f);
+        RTCRayHit ray = makeRay(org,Vec3fa(0.0f,0.0f,1.0f));
+        RTCMultiHit hits[16];
+        const unsigned int numHits = rtcIntersectMulti(scene,&ray.ray,hits,k);
+
+        /* the closest planes get reported in order */
+        passed &= numHits == min(k,numPlanes);
+        for (unsigned int j=0; j<numHits; j++) {
+          passed &= abs(hits[j].t-float(j+1)) < 1E-4f;
+          passed &= hits[j].hit.geomID == geomIDs[j];
+          passed &= hits[j].hit.instID[0] == RTC_INVALID_GEOMETRY_ID;
+        }
+      }
+      AssertNoError(device);
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct IntersectAnyTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    IntersectAnyTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* stack of triangle, quad, and grid planes at z = 0,1,2,... */
+      const unsigned int numPlanes = 6;
+      VerifyScene scene(device,sflags);
+      unsigned int geomIDs[numPlanes];
+      for (unsigned int i=0; i<numPlanes; i++)
+      {
+        const Vec3fa p(-1.0f,-1.0f,float(i));
+        const Vec3fa dx(2.0f,0.0f,0.0f);
+        const Vec3fa dy(0.0f,2.0f,0.0f);
+        Ref<SceneGraph::Node> plane;
+        if      (i%3 == 0) plane = SceneGraph::createTrianglePlane(p,dx,dy,4,4);
+        else if (i%3 == 1) plane = SceneGraph::createQuadPlane(p,dx,dy,4,4);
+        else               plane = SceneGraph::createGridPlane(p,dx,dy,4,4);
+        geomIDs[i] = scene.addGeometry(sflags.qflags,plane);
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      bool passed = true;
+      for (size_t i=0; i<256; i++)
+      {
+        /* some rays start between the planes or miss all planes */
+        const bool miss = i%8 == 7;
+        const Vec3fa org(1.8f*random_float()-0.9f + (miss ? 2.0f : 0.0f),1.8f*random_float()-0.9f,float(i%4)-1.5f);
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0.0f,0.0f,1.0f));
+        rtcIntersectAny(scene,&ray0);
+        if (miss) {
+          passed &= ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID;
+          continue;
+        }
+        if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) {
+          passed = false;
+          continue;
+        }
+
+        /* any hit is one of the planes in front of the origin */
+        const float z = org.z+ray0.ray.tfar;
+        const int plane = int(std::round(z));
+        passed &= abs(z-float(plane)) < 1E-4f && plane >= 0 && plane < int(numPlanes) && float(plane) >= org.z;
+        if (!passed) continue;
+        passed &= ray0.hit.geomID == geomIDs[plane];
+
+        /* the hit data matches the closest hit around that distance */
+        RTCRayHit ray1 = makeRay(org,Vec3fa(0.0f,0.0f,1.0f),ray0.ray.tfar-0.1f,ray0.ray.tfar+0.1f);
+        rtcIntersect1(scene,&ray1);
+        passed &= ray1.hit.geomID == ray0.hit.geomID;
+        passed &= ray1.hit.primID == ray0.hit.primID;
+        passed &= abs(ray1.hit.u-ray0.hit.u) < 1E-4f;
+        passed &= abs(ray1.hit.v-ray0.hit.v) < 1E-4f;
+        passed &= abs(ray1.hit.Ng_z-ray0.hit.Ng_z) < 1E-4f;
+      }
+      AssertNoError(device);
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct RayConeTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    RayConeTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* checkerboards of triangles and quads with every other cell left empty */
+      const size_t numCells = 32;
+      Ref<SceneGraph::TriangleMeshNode> trimesh = SceneGraph::createTrianglePlane(Vec3fa(-1.0f,-1.0f,0.0f),Vec3fa(2.0f,0.0f,0.0f),Vec3fa(0.0f,2.0f,0.0f),numCells,numCells).dynamicCast<SceneGraph::TriangleMeshNode>();
+      Ref<SceneGraph::QuadMeshNode> quadmesh = SceneGraph::createQuadPlane(Vec3fa(-1.0f,3.0f,0.0f),Vec3fa(2.0f,0.0f,0.0f),Vec3fa(0.0f,2.0f,0.0f),numCells,numCells).dynamicCast<SceneGraph::QuadMeshNode>();
+      std::vector<SceneGraph::TriangleMeshNode::Triangle> triangles;
+      std::vector<SceneGraph::QuadMeshNode::Quad> quads;
+      for (size_t i=0; i<numCells*numCells; i++) {
+        if ((i%numCells + i/numCells) % 2) continue;
+        triangles.push_back(trimesh->triangles[2*i+0]);
+        triangles.push_back(trimesh->triangles[2*i+1]);
+        quads.push_back(quadmesh->quads[i]);
+      }
+      trimesh->triangles = triangles;
+      quadmesh->quads = quads;
+
+      VerifyScene scene(device,sflags);
+      const unsigned int geomIDs[2] = {
+        scene.addGeometry(sflags.qflags,trimesh.dynamicCast<SceneGraph::Node>()),
+        scene.addGeometry(sflags.qflags,quadmesh.dynamicCast<SceneGraph::Node>())
+      };
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      RTCIntersectArguments iargs0; rtcInitIntersectArguments(&iargs0);
+      RTCIntersectArguments iargs1; rtcInitIntersectArguments(&iargs1);
+      RTCOccludedArguments oargs1; rtcInitOccludedArguments(&oargs1);
+      iargs1.rayConeWidth = 1E-4f;
+      iargs1.rayConeSpread = 1E-4f;
+      oargs1.rayConeSpread = 4.0f;
+      RTCIntersectArguments iargs2 = iargs0;
+      iargs2.rayConeWidth = 4.0f;
+
+      bool passed = true;
+      for (size_t i=0; i<256; i++)
+      {
+        const size_t mesh = i%2;
+        const size_t x = random_int() % numCells;
+        const size_t y = random_int() % numCells;
+        const bool empty = (x+y) % 2;
+        const Vec3fa org(2.0f*(float(x)+0.5f)/float(numCells)-1.0f, 2.0f*(float(y)+0.5f)/float(numCells)-1.0f + 4.0f*float(mesh), -1.0f);
+        const Vec3fa dir(0.0f,0.0f,1.0f);
+
+        /* a footprint below the size of the leaves does not change the hits */
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scene,&ray0,&iargs0);
+        rtcIntersect1(scene,&ray1,&iargs1);
+        passed &= (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) == empty;
+        passed &= ray1.hit.geomID == ray0.hit.geomID;
+        passed &= ray1.hit.primID == ray0.hit.primID;
+        passed &= ray1.ray.tfar == ray0.ray.tfar;
+
+        /* a footprint above the size of the meshes reports the bounds of the mesh */
+        RTCRayHit ray2 = makeRay(org,dir);
+        rtcIntersect1(scene,&ray2,&iargs2);
+        passed &= ray2.hit.geomID == geomIDs[mesh];
+        passed &= ray2.hit.primID < 2*numCells*numCells;
+        passed &= abs(ray2.ray.tfar-1.0f) < 1E-4f;
+        passed &= ray2.hit.Ng_z == -1.0f;
+
+        RTCRay ray3 = makeRay(org,dir).ray;
+        rtcOccluded1(scene,&ray3,&oargs1);
+        passed &= ray3.tfar == -float(inf);
+
+        /* rays missing the bounds of all meshes still miss */
+        RTCRayHit ray4 = makeRay(org+Vec3fa(4.0f,0.0f,0.0f),dir);
+        rtcIntersect1(scene,&ray4,&iargs2);
+        passed &= ray4.hit.geomID == RTC_INVALID_GEOMETRY_ID;
+      }
+      AssertNoError(device);
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct MortonCodeTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    MortonCodeTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",tri_builder=morton,morton_code_bits=64").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      /* small dense spheres inside a huge ground plane, such that 10 bits per axis cannot separate them */
+      RandomSampler sampler;
+      RandomSampler_init(sampler,0);
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      const float extent = 1E5f;
+      const Vec3fa p0(-extent,-extent,-1.0f);
+      scene0.addPlane(sampler,RTC_BUILD_QUALITY_LOW,64,p0,Vec3fa(2.0f*extent,0,0),Vec3fa(0,2.0f*extent,0));
+      scene1.addPlane(sampler,RTC_BUILD_QUALITY_LOW,64,p0,Vec3fa(2.0f*extent,0,0),Vec3fa(0,2.0f*extent,0));
+      for (int i=0; i<4; i++) {
+        const Vec3fa pos(0.1f*float(i),0.0f,0.0f);
+        scene0.addSphere(sampler,RTC_BUILD_QUALITY_LOW,pos,0.04f,32);
+        scene1.addSphere(sampler,RTC_BUILD_QUALITY_LOW,pos,0.04f,32);
+      }
+      rtcCommitScene(scene0);
+      rtcCommitScene(scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* both builders have to report the same hits */
+      const size_t numRays = 256;
+      RTCRayHit rays0[numRays];
+      RTCRayHit rays1[numRays];
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(0.5f*random_float()-0.1f,0.2f*random_float()-0.1f,10.0f);
+        rays0[i] = rays1[i] = makeRay(org,Vec3fa(0.0f,0.0f,-1.0f));
+      }
+      IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+      IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      bool passed = true;
+      for (size_t i=0; i<numRays; i++)
+      {
+        const RTCRayHit& ray0 = rays0[i];
+        const RTCRayHit& ray1 = rays1[i];
+        if (ivariant & VARIANT_INTERSECT)
+        {
+          passed &= ray0.hit.geomID != RTC_INVALID_GEOMETRY_ID;
+          passed &= ray0.hit.geomID == ray1.hit.geomID;
+          passed &= ray0.hit.primID == ray1.hit.primID;
+          passed &= ray0.ray.tfar == ray1.ray.tfar;
+        }
+        else
+          passed &= ray0.ray.tfar == ray1.ray.tfar;
+      }
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
   struct OverlappingGeometryTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
@@ -3111,6 +4092,36 @@ namespace embree
         rtcReleaseScene(tl_scene);
       }
 
+      {
+        struct HalfTransform {
+          unsigned short tx, ty, tz, scale;
+          unsigned short qr, qi, qj, qk;
+        };
+
+        std::vector<HalfTransform> transforms;
+        for (int i = 1; i < 16; ++i) {
+          HalfTransform T;
+          T.tx = float_to_half(i * 5.f); T.ty = float_to_half(0.f); T.tz = float_to_half(0.f);
+          T.scale = float_to_half(1.5f);
+          T.qr = float_to_half(0.7071068f); T.qi = float_to_half(0.f); T.qj = float_to_half(0.f); T.qk = float_to_half(0.7071068f);
+          transforms.push_back(T);
+        }
+
+        RTCScene tl_scene = rtcNewScene(device);
+        RTCGeometry instance_array = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_INSTANCE_ARRAY);
+        rtcSetSharedGeometryBuffer(instance_array, RTC_BUFFER_TYPE_TRANSFORM, 0, RTC_FORMAT_QUATERNION_TRANSLATION_SCALE_HALF, (void*)transforms.data(), 0, sizeof(HalfTransform), transforms.size());
+        rtcSetGeometryInstancedScene(instance_array, bl_scene);
+        rtcAttachGeometry(tl_scene,instance_array);
+        rtcReleaseGeometry(instance_array);
+        rtcCommitGeometry(instance_array);
+        rtcCommitScene(tl_scene);
+        AssertNoError(device);
+
+        passed &= doIntersectionTests(tl_scene);
+        assert(passed);
+        rtcReleaseScene(tl_scene);
+      }
+
       AssertNoError(device);
 
       return (VerifyApplication::TestReturnValue) passed;
@@ -6154,6 +7165,7 @@ namespace embree
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_ROBUST,        RTC_BUILD_QUALITY_MEDIUM));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_COMPACT,       RTC_BUILD_QUALITY_MEDIUM));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_COMPACT,RTC_BUILD_QUALITY_MEDIUM));
+    sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_WATERTIGHT,    RTC_BUILD_QUALITY_MEDIUM));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_NONE,       RTC_BUILD_QUALITY_HIGH));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,       RTC_BUILD_QUALITY_LOW));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,       RTC_BUILD_QUALITY_MEDIUM));
@@ -6165,6 +7177,8 @@ namespace embree
     sceneFlagsRobust.push_back(SceneFlags(RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_COMPACT,RTC_BUILD_QUALITY_MEDIUM));
     sceneFlagsRobust.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC | RTC_SCENE_FLAG_ROBUST,        RTC_BUILD_QUALITY_LOW));
     sceneFlagsRobust.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC | RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_COMPACT,RTC_BUILD_QUALITY_LOW));
+    sceneFlagsRobust.push_back(SceneFlags(RTC_SCENE_FLAG_WATERTIGHT,    RTC_BUILD_QUALITY_MEDIUM));
+    sceneFlagsRobust.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC | RTC_SCENE_FLAG_WATERTIGHT,    RTC_BUILD_QUALITY_LOW));
 
     sceneFlagsDynamic.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,       RTC_BUILD_QUALITY_LOW));
     sceneFlagsDynamic.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,       RTC_BUILD_QUALITY_MEDIUM));
@@ -6241,6 +7255,91 @@ namespace embree
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
       groups.pop();
       
+      push(new TestGroup("ray_distribution_hint",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new RayDistributionHintTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("treelet_restructure",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new TreeletRestructureTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_HIGH));
+      groups.pop();
+
+      push(new TestGroup("intersection_cost",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new IntersectionCostTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("instance_unrolling",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new InstanceOptimizationTest(to_string(sflags,imode,ivariant),isa,"instance_unroll_threshold=256",sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("instance_object_bounds",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new InstanceOptimizationTest(to_string(sflags,imode,ivariant),isa,"instance_object_bounds_test=1",sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("curve_lod",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new CurveLODTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("hair_subdivision",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new HairSubdivisionTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("intersect_multi",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new IntersectMultiTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("intersect_any",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new IntersectAnyTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("ray_cone",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new RayConeTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("morton_code_64",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new MortonCodeTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("commit_statistics",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new CommitStatisticsTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("traversal_statistics",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new TraversalStatisticsTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("ray_cost",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new RayCostTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
       push(new TestGroup("overlapping_primitives",true,false));
       for (auto sflags : sceneFlags)
         groups.top()->add(new OverlappingGeometryTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,clamp(int(intensity*10000),1000,100000)));
@@ -55,6 +55,7 @@ namespace embree
         else if (mode == "geomID"  ) shader = SHADER_GEOMID;
         else if (mode == "primID"  ) shader = SHADER_GEOMID_PRIMID;
         else if (mode == "ao" ) shader = SHADER_AO;
+        else if (mode == "cost"    ) { shader = SHADER_COST; scale = cin->getFloat(); }
         else throw std::runtime_error("invalid shader:" +mode);
       },
       "--shader <string>: sets shader to use at startup\n"
@@ -67,6 +68,7 @@ namespace embree
       "  Ng: visualization of shading normal\n"
       "  cycles <float>: CPU cycle visualization\n"
       "  ao: ambient occlusion\n"      
+      "  cost <float>: traversal cost heat map with per geometry cost report\n"
       "  geomID: visualization of geometry ID\n"
       "  primID: visualization of geometry and primitive ID");
 
@@ -179,6 +181,20 @@ namespace embree
         shader = SHADER_CYCLES; 
         g_changed = true;
       }
+      else if (key == GLFW_KEY_F11) {
+        if (shader == SHADER_COST) scale *= 2.0f;
+        else scale = 1.0f/256.0f;
+        renderFrame = renderFrameDebugShader;
+        shader = SHADER_COST;
+        g_changed = true;
+      }
+      else if (key == GLFW_KEY_F12) {
+        if (shader == SHADER_COST) scale *= 0.5f;
+        else scale = 1.0f/256.0f;
+        renderFrame = renderFrameDebugShader;
+        shader = SHADER_COST;
+        g_changed = true;
+      }
       else
         TutorialApplication::keypressed(key);
     }
@@ -199,6 +215,7 @@ namespace embree
       case SHADER_GEOMID   : renderFrame = renderFrameDebugShader; break;
       case SHADER_GEOMID_PRIMID: renderFrame = renderFrameDebugShader; break;
       case SHADER_AO: renderFrame = renderFrameAOShader; break;      
+      case SHADER_COST     : renderFrame = renderFrameDebugShader; break;
       };
       
       /* load default scene if none specified */
@@ -402,8 +402,11 @@ extern "C" void device_render (int* pixels,
 }
 
 /* called by the C++ code for cleanup */
+extern "C" void printGeometryCost();
+
 extern "C" void device_cleanup ()
 {
+  printGeometryCost();
   TutorialData_Destructor(&data);
 }
 
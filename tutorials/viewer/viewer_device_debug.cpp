@@ -24,6 +24,18 @@ static const sycl::specialization_id<RTCFeatureFlags> spec_feature_mask;
 
 extern "C" RTCFeatureFlags g_feature_mask;
 
+/* traversal cost of the rays that hit some geometry */
+struct GeometryCost
+{
+  std::atomic<size_t> rays;
+  std::atomic<size_t> nodes;
+  std::atomic<size_t> primitives;
+};
+
+/* traversal cost per geometry gathered by the cost shader */
+static GeometryCost* g_geometry_cost = nullptr;
+static unsigned int g_num_geometry_cost = 0;
+
 struct DebugShaderData
 {
   RTCScene scene;
@@ -35,6 +47,10 @@ struct DebugShaderData
   float debug;
 
   Shader shader;
+
+  /* traversal cost per geometry */
+  GeometryCost* geometry_cost;
+  unsigned int num_geometry_cost;
 };
 
 void DebugShaderData_Constructor(DebugShaderData* This)
@@ -44,6 +60,42 @@ void DebugShaderData_Constructor(DebugShaderData* This)
   This->scale = scale;
   This->debug = g_debug;
   This->shader = shader;
+
+#if !defined(EMBREE_SYCL_TUTORIAL) || defined(EMBREE_SYCL_RT_SIMULATION)
+  if (shader == SHADER_COST && g_ispc_scene && !g_geometry_cost) {
+    g_num_geometry_cost = g_ispc_scene->numGeometries;
+    g_geometry_cost = new GeometryCost[g_num_geometry_cost]();
+  }
+#endif
+  This->geometry_cost = g_geometry_cost;
+  This->num_geometry_cost = g_num_geometry_cost;
+}
+
+/* prints the geometries with the highest traversal cost */
+extern "C" void printGeometryCost()
+{
+  if (!g_geometry_cost)
+    return;
+
+  std::vector<unsigned int> order;
+  for (unsigned int i=0; i<g_num_geometry_cost; i++)
+    if (g_geometry_cost[i].rays) order.push_back(i);
+
+  auto cost = [] (unsigned int i) { return g_geometry_cost[i].nodes + g_geometry_cost[i].primitives; };
+  std::sort(order.begin(),order.end(),[&] (unsigned int a, unsigned int b) { return cost(a) > cost(b); });
+
+  std::cout << "traversal cost per geometry:" << std::endl;
+  for (size_t i=0; i<min(order.size(),size_t(16)); i++)
+  {
+    const GeometryCost& c = g_geometry_cost[order[i]];
+    std::cout << "  geomID = " << order[i]
+              << ", rays = " << c.rays
+              << ", nodes/ray = " << double(c.nodes)/double(c.rays)
+              << ", primitives/ray = " << double(c.primitives)/double(c.rays) << std::endl;
+  }
+
+  delete[] g_geometry_cost; g_geometry_cost = nullptr;
+  g_num_geometry_cost = 0;
 }
 
 #define RENDER_FRAME_FUNCTION_ISPC(Name)                             \
@@ -208,6 +260,13 @@ Vec3fa randomColor(const int ID)
   return Vec3fa(r*oneOver255f,g*oneOver255f,b*oneOver255f);
 }
 
+/* maps [0,1] to blue over green to red */
+Vec3fa heatMap(float t)
+{
+  t = clamp(t,0.0f,1.0f);
+  return clamp(Vec3fa(4.0f*t-2.0f,2.0f-abs(4.0f*t-2.0f),2.0f-4.0f*t),Vec3fa(0.0f),Vec3fa(1.0f));
+}
+
 /* renders a single pixel with eyelight shading */
 Vec3fa renderPixelDebugShader(const DebugShaderData& data, float x, float y, const ISPCCamera& camera, RayStats& stats, const RTCFeatureFlags feature_mask)
 {
@@ -223,6 +282,8 @@ Vec3fa renderPixelDebugShader(const DebugShaderData& data, float x, float y, con
   ray.time() = data.debug;
 
   /* intersect ray with scene */
+  RTCRayCost cost;
+  cost.nodes = cost.leaves = cost.primitives = 0;
   int64_t c0 = get_tsc();
   if (data.shader == SHADER_OCCLUSION)
   {
@@ -236,6 +297,9 @@ Vec3fa renderPixelDebugShader(const DebugShaderData& data, float x, float y, con
     RTCIntersectArguments args;
     rtcInitIntersectArguments(&args);
     args.feature_mask = feature_mask;
+#if !defined(__SYCL_DEVICE_ONLY__)
+    if (data.shader == SHADER_COST) args.cost = &cost;
+#endif
     rtcIntersect1(data.scene,RTCRayHit_(ray),&args);
   }
   
@@ -304,6 +368,22 @@ Vec3fa renderPixelDebugShader(const DebugShaderData& data, float x, float y, con
     
   case SHADER_CYCLES:
     return Vec3fa((float)(c1-c0)*data.scale,0.0f,0.0f);
+
+  case SHADER_COST:
+
+#if !defined(__SYCL_DEVICE_ONLY__)
+    if (ray.geomID != RTC_INVALID_GEOMETRY_ID)
+    {
+      /* attribute cost to the geometry hit in the top level scene */
+      const unsigned int geomID = ray.instID[0] != RTC_INVALID_GEOMETRY_ID ? ray.instID[0] : ray.geomID;
+      if (geomID < data.num_geometry_cost) {
+        data.geometry_cost[geomID].rays++;
+        data.geometry_cost[geomID].nodes += cost.nodes;
+        data.geometry_cost[geomID].primitives += cost.primitives;
+      }
+    }
+#endif
+    return heatMap((float)(cost.nodes+cost.primitives)*data.scale);
     
   case SHADER_AO:
     return Vec3fa(0,0,0);